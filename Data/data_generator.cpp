@@ -8,6 +8,7 @@
 
 // Implementation of functions in data_generator.hpp
 
+#include <algorithm>
 #include <cmath>
 #include "data_generator.hpp"
 #include <iostream>
@@ -25,6 +26,8 @@ std::string toString(gen_data_type genDataType) {
         case CONDAT_WORST_CASE: return "CONDAT-WORST-CASE";
         case KKT_LINEAR_L2: return "KKT-Linear-L2";
         case KKT_HUBER: return "KKT-HUBER";
+        case KKT_ISOTONIC: return "KKT-ISOTONIC";
+        case KKT_TV_ND: return "KKT-TV-ND";
         default:
             return "";
     }
@@ -151,6 +154,23 @@ std::vector<data_type> genPWFuncs(int n, int pwDeg,
     return pw;
 }
 
+void quantizePWBkps(int n, const std::vector<int>& bkpNums, data_type step,
+                    std::vector<data_type>* pw) {
+    assert(n >= 1 && n == bkpNums.size());
+    assert(step > 0 && pw != NULL);
+    int pwIndex = 0;
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < bkpNums[i]; ++j) {
+            data_type& lambda = (*pw)[pwIndex + 1 + 2 * j];
+            lambda = std::round(lambda / step) * step;
+            if (j > 0 && lambda <= (*pw)[pwIndex + 2 * j - 1]) {
+                lambda = (*pw)[pwIndex + 2 * j - 1] + step;
+            }
+        }
+        pwIndex += 2 * bkpNums[i] + 1;
+    }
+}
+
 void fillSep(int n, InputData* inputData, data_type in_lambda,
              bool withSample) {
     assert(n >= 1);
@@ -346,8 +366,128 @@ void genLinearL2Funcs(int n, InputData* inputData) {
         sum += inputData->_cDev[i];
     }
     inputData->_cDev[n - 1] = -sum;
+    // Unit edge weights: the plain graph Laplacian.
     for (int i = 0; i < n - 1; ++i) {
-        inputData->_cSep[i] = 0.5;
+        inputData->_cSep[i] = 1;
+    }
+}
+
+void genIsotonicFuncs(int n, InputData* inputData) {
+    assert(n >= 1);
+    assert(inputData != NULL && inputData->_n == n);
+    std::uniform_real_distribution<data_type> noise_distribution(-ISOTONIC_NOISE, ISOTONIC_NOISE);
+    std::uniform_real_distribution<data_type>
+        cdev_distribution(LPLQ_CDEV_UNIF_LEFT, LPLQ_CDEV_UNIF_RIGHT);
+    std::uniform_real_distribution<data_type> csep_distribution(0, ISOTONIC_CSEP_UNIF_RIGHT);
+    for (int i = 0; i < n; ++i) {
+        inputData->_aDev[i] = -1 + 2.0 * i / n + noise_distribution(gen);
+        inputData->_cDev[i] = cdev_distribution(gen);
+    }
+    for (int i = 0; i < n - 1; ++i) {
+        inputData->_cSep[i] = csep_distribution(gen);
+    }
+    inputData->_isotonic = true;
+}
+
+void genLocalEdits(int n, int numEdits, InputData* inputData, std::vector<int>* edited) {
+    assert(n >= 1 && numEdits >= 0 && numEdits <= n);
+    assert(inputData != NULL && inputData->_n == n && edited != NULL);
+    std::uniform_int_distribution<int> index_distribution(0, n - 1);
+    std::uniform_real_distribution<data_type>
+        adev_distribution(LPLQ_ADEV_UNIF_LEFT, LPLQ_ADEV_UNIF_RIGHT);
+    edited->clear();
+    while (edited->size() < numEdits) {
+        int i = index_distribution(gen);
+        if (std::find(edited->begin(), edited->end(), i) == edited->end()) {
+            edited->push_back(i);
+            inputData->_aDev[i] = adev_distribution(gen);
+        }
+    }
+}
+
+void genBatchLengths(int count, int minN, int maxN, std::vector<int>* lengths) {
+    assert(count >= 0 && minN >= 1 && minN <= maxN && lengths != NULL);
+    std::uniform_real_distribution<double>
+        log_distribution(log((double)minN), log((double)maxN + 1));
+    lengths->resize(count);
+    for (int k = 0; k < count; ++k) {
+        int n = (int)exp(log_distribution(gen));
+        (*lengths)[k] = std::max(minN, std::min(maxN, n));
+    }
+}
+
+void genPiecewiseConstantArray(const std::vector<int>& dims, std::vector<data_type>* y) {
+    assert(!dims.empty() && y != NULL);
+    int numAxes = (int)dims.size();
+    std::vector<long long> numBlocks(numAxes);
+    long long size = 1, totalBlocks = 1;
+    for (int d = 0; d < numAxes; ++d) {
+        assert(dims[d] >= 1);
+        numBlocks[d] = (dims[d] + TV_ND_BLOCK_SIZE - 1) / TV_ND_BLOCK_SIZE;
+        size *= dims[d];
+        totalBlocks *= numBlocks[d];
+    }
+    std::uniform_real_distribution<data_type> level_distribution(-1, 1);
+    std::normal_distribution<data_type> noise_distribution(0, TV_ND_NOISE_STD);
+    std::vector<data_type> levels(totalBlocks);
+    for (long long b = 0; b < totalBlocks; ++b) {
+        levels[b] = level_distribution(gen);
+    }
+    y->resize(size);
+    // Multi-index of the current element, last axis fastest.
+    std::vector<int> index(numAxes, 0);
+    for (long long i = 0; i < size; ++i) {
+        long long block = 0;
+        for (int d = 0; d < numAxes; ++d) {
+            block = block * numBlocks[d] + index[d] / TV_ND_BLOCK_SIZE;
+        }
+        (*y)[i] = levels[block] + noise_distribution(gen);
+        for (int d = numAxes - 1; d >= 0 && ++index[d] == dims[d]; --d) {
+            index[d] = 0;
+        }
+    }
+}
+
+void genRandomTree(int n, std::vector<int>* parent) {
+    assert(n >= 1 && parent != NULL);
+    parent->resize(n);
+    (*parent)[0] = -1;
+    for (int i = 1; i < n; ++i) {
+        std::uniform_int_distribution<int> parent_distribution(0, i - 1);
+        (*parent)[i] = parent_distribution(gen);
+    }
+}
+
+void genCaterpillarTree(int n, std::vector<int>* parent) {
+    assert(n >= 1 && parent != NULL);
+    std::bernoulli_distribution spine_distribution(CATERPILLAR_SPINE_PROB);
+    parent->resize(n);
+    (*parent)[0] = -1;
+    int spineEnd = 0;
+    for (int i = 1; i < n; ++i) {
+        (*parent)[i] = spineEnd;
+        if (spine_distribution(gen)) {
+            spineEnd = i;
+        }
+    }
+}
+
+void genMissingObs(int n, data_type obsRatio, InputData* inputData) {
+    assert(n >= 1);
+    assert(obsRatio >= 0 && obsRatio <= 1);
+    assert(inputData != NULL && inputData->_n == n);
+    std::bernoulli_distribution obs_distribution(obsRatio);
+    for (int i = 0; i < n; ++i) {
+        if (!obs_distribution(gen)) {
+            inputData->_cDev[i] = 0;
+        }
+    }
+}
+
+void quantize(int n, data_type step, data_type* values) {
+    assert(n >= 0 && step > 0 && values != NULL);
+    for (int i = 0; i < n; ++i) {
+        values[i] = std::round(values[i] / step) * step;
     }
 }
 
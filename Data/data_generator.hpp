@@ -29,6 +29,8 @@ typedef enum GEN_DATA_TYPE {
     CONDAT_WORST_CASE,
     KKT_LINEAR_L2,
     KKT_HUBER,
+    KKT_ISOTONIC,
+    KKT_TV_ND,
 } gen_data_type;
 
 // Map from data type to string for output.
@@ -78,6 +80,11 @@ std::vector<int> genPWBkpNums(int n, int bkpNumLB, int bkpNumUB);
 // generate the list of breakpoints and each piece's coefficients.
 std::vector<data_type> genPWFuncs(int n, int pwDeg,
                                   const std::vector<int>& bkpNums);
+// Round the breakpoints of the piecewise linear functions in ${pw} (as
+// generated by genPWFuncs) to multiples of ${step}, keeping them strictly
+// increasing within each function, so that breakpoints tie across nodes.
+void quantizePWBkps(int n, const std::vector<int>& bkpNums, data_type step,
+                    std::vector<data_type>* pw);
 // Fills in separation term coefficients
 // If in_lambda >= 0, uniform version; o/w, weighted version.
 // If withSample set, still weighted version, but the weights are sampled around in_lambda.
@@ -124,6 +131,46 @@ void genLpLqFuncs(int n, InputData* inputData, gen_data_type genDataType,
 // Generate data for linear_l2 (graph Laplacian) problem.
 void genLinearL2Funcs(int n, InputData* inputData);
 
+// Drop observations to simulate missing data: each _cDev[i] is set to 0
+// with probability 1 - ${obsRatio}.
+void genMissingObs(int n, data_type obsRatio, InputData* inputData);
+
+// Round ${values}[0, n) to multiples of ${step}. Continuous samples tie with
+// probability zero; quantized ones make breakpoints coincide.
+void quantize(int n, data_type step, data_type* values);
+
+// Generate data for isotonic problems: a noisy increasing trend
+// a_i = -1 + 2i/n + U(-ISOTONIC_NOISE, ISOTONIC_NOISE), small l1 separation
+// weights, and _isotonic set.
+const data_type ISOTONIC_NOISE = 0.5;
+const data_type ISOTONIC_CSEP_UNIF_RIGHT = 0.05;
+void genIsotonicFuncs(int n, InputData* inputData);
+
+// Generate a noisy piecewise constant N-D array (row-major over ${dims}):
+// levels U(-1, 1) on blocks of TV_ND_BLOCK_SIZE per axis, plus Gaussian noise
+// with standard deviation TV_ND_NOISE_STD.
+const int TV_ND_BLOCK_SIZE = 32;
+const data_type TV_ND_NOISE_STD = 0.2;
+void genPiecewiseConstantArray(const std::vector<int>& dims, std::vector<data_type>* y);
+
+// Edit ${numEdits} distinct random nodes in place, for incremental re-solves:
+// _aDev[i] is redrawn from U(LPLQ_ADEV_UNIF_LEFT, LPLQ_ADEV_UNIF_RIGHT).
+// The edited nodes are returned in ${edited}.
+void genLocalEdits(int n, int numEdits, InputData* inputData, std::vector<int>* edited);
+
+// Generate ${count} problem lengths for batch solves, log-uniform on
+// [minN, maxN], so that short problems dominate the count and long ones
+// the work.
+void genBatchLengths(int count, int minN, int maxN, std::vector<int>* lengths);
+
+// Generate tree shapes for InputData::setTree (parent[0] = -1, parent[i] < i).
+// Random recursive tree: parent[i] is uniform on [0, i - 1] (depth O(log n)).
+void genRandomTree(int n, std::vector<int>* parent);
+// Caterpillar: each new node extends the spine with probability
+// CATERPILLAR_SPINE_PROB, otherwise it is a leaf on the current spine end.
+const double CATERPILLAR_SPINE_PROB = 0.5;
+void genCaterpillarTree(int n, std::vector<int>* parent);
+
 // Generate Huber parameters.
 void genHuberFuncs(int n, const std::vector<data_type>& baselines,
                    InputData* inputData, bool isDev = true,
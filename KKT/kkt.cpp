@@ -8,9 +8,22 @@
 
 //  Implementation of kkt.hpp
 
+#include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <cmath>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <mutex>
+#include <queue>
+#include <sstream>
+#include <thread>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
 #include "kkt.hpp"
 #include "utils.hpp"
 
@@ -218,6 +231,10 @@ data_type KKTSolver::compSepInv(const InputData& inputData, const data_type& fDr
             z = -inputData._huberS[index];
         }
     }
+    if (inputData._isotonic && z < 0) {
+        // The constraint x_i <= x_{i+1} absorbs any negative derivative.
+        z = 0;
+    }
     return z;
 }
 
@@ -226,6 +243,12 @@ int KKTSolver::propagate(const InputData& inputData, OutputData* outputData,
     assert(outputData != NULL && index >= 0);
     assert(out_fDrvtValue != NULL);
     int n = inputData._n;
+    if (inputData._isotonic && index > 0 &&
+        outputData->_x[index] < outputData->_x[index - 1]) {
+        // Infeasible start.
+        outputData->_bounds[index][0] = outputData->_x[index];
+        return -1;
+    }
     compDrvt(inputData, *outputData, index, true, out_fDrvtValue);
     data_type& fDrvtValue = *out_fDrvtValue;
 
@@ -279,57 +302,721 @@ int KKTSolver::propagate(const InputData& inputData, OutputData* outputData,
     return 0;
 }
 
+// ${n} values aligned to KKT_WORKSPACE_ALIGNMENT, to be released by free().
+static data_type* alignedAlloc(int n) {
+    void* ptr = NULL;
+    int status = posix_memalign(&ptr, KKT_WORKSPACE_ALIGNMENT,
+                                std::max(n, 1) * sizeof(data_type));
+    assert(status == 0);
+    (void)status;
+    return (data_type*)ptr;
+}
+
+InputData& KKTWorkspace::prepare(int n, int p, int q) {
+    assert(n >= 1 && p >= 1 && q >= 1);
+    if (n > _capacity) {
+        // Geometric growth, for a stream of increasing sizes.
+        _capacity = std::max(n, 2 * _capacity);
+        data_type** buffers[] = {&_input._cDev, &_input._aDev, &_input._cSep,
+                                 &_output._x};
+        for (int k = 0; k < 4; ++k) {
+            free(*buffers[k]);
+            *buffers[k] = alignedAlloc(_capacity);
+        }
+        _output._capacity = _capacity;
+        _output._bounds.resize(_capacity, _input._lb, _input._ub);
+        _numAllocations += 5;
+    }
+    _input._n = n;
+    _input._p = p;
+    _input._q = q;
+    _output._n = n;
+    return _input;
+}
+
 void KKTSolver::solve(const InputData& inputData, OutputData* result) {
+    solveFrom(inputData, result, NULL, NULL);
+}
+
+void KKTSolver::solve(KKTWorkspace* workspace) {
+    assert(workspace != NULL);
+    workspace->restart();
+    solve(workspace->input(), &workspace->output());
+}
+
+void KKTSolver::solveFrom(const InputData& inputData, OutputData* result,
+                          const data_type* guess, const data_type* steps) {
     assert(inputData._n >= 1 && inputData._p >= 1 && inputData._q >= 1);
     assert(result != NULL);
+    assert((guess == NULL) == (steps == NULL));
 
     for (int i = 0; i < inputData._n; ++i) {
-        data_type l, u;
-        l = result->_bounds[i][0];
-        u = result->_bounds[i][1];
+        if (solveNode(inputData, result, i, guess, steps)) {
+            return;
+        }
+    }
+}
 
-        if (u - l < inputData._solEsp) {
-            result->_x[i] = (u + l) / 2;
-            if (inputData._deviationType == InputData::PIECEWISE_LP) {
-                // Move to the next piecewise deviation function.
-                result->_stIndex += (inputData._pwDeg + 1) *
-                                        inputData._bkpNums[i]
-                                    + inputData._pwDeg;
-            }
-            continue;
+bool KKTSolver::solveNode(const InputData& inputData, OutputData* result, int i,
+                          const data_type* guess, const data_type* steps) {
+    data_type l, u;
+    l = result->_bounds[i][0];
+    u = result->_bounds[i][1];
+
+    if (u - l < inputData._solEsp) {
+        result->_x[i] = (u + l) / 2;
+        if (inputData._deviationType == InputData::PIECEWISE_LP) {
+            // Move to the next piecewise deviation function.
+            result->_stIndex += (inputData._pwDeg + 1) *
+                                    inputData._bkpNums[i]
+                                + inputData._pwDeg;
         }
+        return false;
+    }
+    // Galloping step from the guess; 0 once bisecting.
+    data_type step = 0;
+    if (guess != NULL) {
+        result->_x[i] = std::min(std::max(guess[i], l), u);
+        step = steps[i];
+    } else {
         result->_x[i] = (l + u) / 2;
-        int stIndex = result->_stIndex;
-        data_type fDrvtValue;
-        int state = propagate(inputData, result, i, &fDrvtValue);
-        while (u - l >= inputData._solEsp) {
-            if (state < 0) {
-                // Go up.
-                l = result->_x[i];
-            } else if (state > 0) {
-                // Go down.
-                u = result->_x[i];
-            } else {
-                if (fabs(fDrvtValue) < inputData._drvtEsp) {
-                    return;
-                } else if (fDrvtValue < 0) {
-                    // Go up.
-                    l = result->_x[i];
-                } else {
-                    // Go down.
-                    u = result->_x[i];
-                }
+    }
+    int stIndex = result->_stIndex;
+    data_type fDrvtValue;
+    int state = propagate(inputData, result, i, &fDrvtValue);
+    int prevDirection = 0;
+    while (u - l >= inputData._solEsp) {
+        // +1: Go up; -1: Go down.
+        int direction;
+        if (state < 0) {
+            direction = 1;
+        } else if (state > 0) {
+            direction = -1;
+        } else {
+            if (fabs(fDrvtValue) < inputData._drvtEsp) {
+                return true;
             }
+            direction = fDrvtValue < 0 ? 1 : -1;
+        }
+        if (direction > 0) {
+            l = result->_x[i];
+        } else {
+            u = result->_x[i];
+        }
+        if (prevDirection != 0 && direction != prevDirection) {
+            // Bracketed: bisect from here on.
+            step = 0;
+        }
+        prevDirection = direction;
+        data_type next = result->_x[i] + direction * step;
+        if (step > 0 && next > l && next < u) {
+            result->_x[i] = next;
+            step *= 2;
+        } else {
+            step = 0;
             result->_x[i] = (l + u) / 2;
-            result->_stIndex = stIndex;
-            state = propagate(inputData, result, i, &fDrvtValue);
         }
         result->_stIndex = stIndex;
+        state = propagate(inputData, result, i, &fDrvtValue);
+    }
+    result->_stIndex = stIndex;
+    if (inputData._deviationType == InputData::PIECEWISE_LP) {
+        // Move to the next piecewise deviation function.
+        result->_stIndex += (inputData._pwDeg + 1) * inputData._bkpNums[i]
+                            + inputData._pwDeg;
+    }
+    return false;
+}
+
+void KKTSolver::solveSweep(InputData* inputData, const std::vector<data_type>& scales,
+                           const std::function<void(int, const InputData&,
+                                                    const OutputData&)>& callback) {
+    assert(inputData != NULL && !scales.empty());
+    int n = inputData->_n;
+    data_type minStep = SWEEP_MIN_STEP * inputData->_solEsp;
+    std::vector<data_type> cSep(inputData->_cSep, inputData->_cSep + n - 1);
+    OutputData result(*inputData);
+    std::vector<data_type> prevX(n), steps(n, minStep);
+    for (int k = 0; k < scales.size(); ++k) {
+        assert(scales[k] >= 0);
+        for (int i = 0; i < n - 1; ++i) {
+            inputData->_cSep[i] = scales[k] * cSep[i];
+        }
+        result.reset(*inputData);
+        if (k == 0) {
+            solve(*inputData, &result);
+        } else {
+            solveFrom(*inputData, &result, prevX.data(), steps.data());
+            for (int j = 0; j < n; ++j) {
+                steps[j] = std::max((data_type)fabs(result._x[j] - prevX[j]), minStep);
+            }
+        }
+        std::copy(result._x, result._x + n, prevX.begin());
+        callback(k, *inputData, result);
+    }
+    std::copy(cSep.begin(), cSep.end(), inputData->_cSep);
+}
+
+std::string toString(kkt_engine engine) {
+    switch (engine) {
+        case ENGINE_NONE: return "None";
+        case ENGINE_SOLVE: return "KKT";
+        case ENGINE_DP: return "DP";
+        case ENGINE_FAST_L2_L1: return "KKT-Fast-L2-L1";
+        case ENGINE_CONDAT: return "Condat";
+        case ENGINE_TAUT_STRING: return "Taut String";
+        case ENGINE_FAST_L1_L1: return "KKT-Fast-L1-L1";
+        case ENGINE_FAST_HUBER_L1: return "KKT-Fast-Huber-L1";
+        case ENGINE_FAST_L2_HUBER: return "KKT-Fast-L2-Huber";
+        case ENGINE_FAST_PWL1_L1: return "KKT-Fast-PWL1-L1";
+        case ENGINE_FAST_PWL2_L1: return "KKT-Fast-PWL2-L1";
+        case ENGINE_FAST_L2_L2: return "KKT-Thomas";
+        case ENGINE_FAST_L2_L2_PARALLEL: return "KKT-Thomas-Parallel";
+        case ENGINE_SPARSE: return "KKT-Sparse";
+        case ENGINE_PAV: return "PAV";
+        case ENGINE_TREE: return "Tree";
+        default:
+            return "";
+    }
+}
+
+// Measured with the comparison profiles (n = 1e5 - 1e7):
+//   l2-l2: Thomas 36 ms vs. KKT 2.5 s at n = 1e6;
+//   missing observations: KKT-Sparse 27 ms vs. KKT 224 ms at n = 1e5, 10% observed;
+//   l2-l1: Taut String 6 ms vs. KKT-Fast 25 ms at n = 1e5 (Condat is faster on
+//     typical inputs but quadratic on CONDAT_WORST_CASE, so it is opt-in);
+//   l1-l1 and pwl1-l1: DP, which is exact when breakpoints tie (KKT-Fast is
+//     faster, but left opt-in);
+//   pwl2-l1: DP wins up to ~15 breakpoints per node (68 vs. 155 ms at 7.5).
+std::vector<KKTEngineRule> KKTSolver::defaultEngineRules() {
+    return {
+        KKTEngineRule(ENGINE_TREE),
+        KKTEngineRule(ENGINE_PAV),
+        KKTEngineRule(ENGINE_FAST_L2_L2_PARALLEL, 1000000),
+        KKTEngineRule(ENGINE_FAST_L2_L2),
+        KKTEngineRule(ENGINE_SPARSE),
+        KKTEngineRule(ENGINE_TAUT_STRING),
+        KKTEngineRule(ENGINE_FAST_L2_L1),
+        KKTEngineRule(ENGINE_DP, 1, INT_MAX, 15),
+        KKTEngineRule(ENGINE_FAST_PWL2_L1),
+        KKTEngineRule(ENGINE_DP),  // pwl1-l1 above 15 breakpoints.
+        KKTEngineRule(ENGINE_FAST_HUBER_L1),
+        KKTEngineRule(ENGINE_FAST_L2_HUBER),
+        KKTEngineRule(ENGINE_SOLVE),
+    };
+}
+
+// Input properties that the engine preconditions depend on.
+struct EngineFeatures {
+    bool _uniformDev = true;  // All _cDev equal.
+    bool _uniformSep = true;  // All _cSep equal.
+    bool _missing = false;  // Some _cDev[i] = 0.
+    data_type _aveBkps = 0;  // Average breakpoints per node.
+};
+
+static void compEngineFeatures(const InputData& inputData, EngineFeatures* features) {
+    int n = inputData._n;
+    if (inputData._deviationType == InputData::PIECEWISE_LP) {
+        long long totalBkps = 0;
+        for (int i = 0; i < n; ++i) {
+            totalBkps += inputData._bkpNums[i];
+        }
+        features->_aveBkps = (data_type)totalBkps / n;
+        features->_uniformDev = false;
+    } else {
+        for (int i = 0; i < n; ++i) {
+            if (inputData._cDev[i] == 0) {
+                features->_missing = true;
+            }
+            if (inputData._cDev[i] != inputData._cDev[0]) {
+                features->_uniformDev = false;
+            }
+        }
+    }
+    for (int i = 1; i < n - 1; ++i) {
+        if (inputData._cSep[i] != inputData._cSep[0]) {
+            features->_uniformSep = false;
+            break;
+        }
+    }
+}
+
+// Preconditions of each engine.
+static bool engineApplies(kkt_engine engine, const InputData& inputData,
+                          const EngineFeatures& features, int numThreads) {
+    int n = inputData._n, p = inputData._p, q = inputData._q;
+    bool lp = inputData._deviationType == InputData::LP;
+    bool pw = inputData._deviationType == InputData::PIECEWISE_LP;
+    bool huberD = inputData._deviationType == InputData::HUBER_D;
+    bool lq = inputData._separationType == InputData::LQ;
+    bool huberS = inputData._separationType == InputData::HUBER_S;
+    if (inputData._parent != NULL) {
+        // The chain engines ignore the tree.
+        return engine == ENGINE_TREE && !inputData._isotonic && lq && q == 1 &&
+            (pw || (lp && (p == 1 || p == 2)));
+    }
+    if (inputData._isotonic) {
+        // Only these two handle the constraints.
+        return engine == ENGINE_SOLVE ||
+            (engine == ENGINE_PAV && (lp || huberD) && lq && q == 1);
+    }
+    switch (engine) {
+        case ENGINE_SOLVE: return true;
+        case ENGINE_DP:
+            return lq && q == 1 && (pw || (lp && (p == 1 || p == 2)));
+        case ENGINE_FAST_L2_L1: return n >= 2 && lp && lq && p == 2 && q == 1;
+        case ENGINE_CONDAT:
+            return lp && lq && p == 2 && q == 1 && !features._missing &&
+                features._uniformDev && features._uniformSep;
+        case ENGINE_TAUT_STRING:
+            return lp && lq && p == 2 && q == 1 && !features._missing;
+        case ENGINE_FAST_L1_L1: return n >= 2 && lp && lq && p == 1 && q == 1;
+        case ENGINE_FAST_HUBER_L1: return n >= 2 && huberD && lq && q == 1;
+        case ENGINE_FAST_L2_HUBER: return n >= 2 && lp && huberS && p == 2;
+        case ENGINE_FAST_PWL1_L1:
+            return n >= 2 && pw && lq && q == 1 && inputData._pwDeg == 1;
+        case ENGINE_FAST_PWL2_L1:
+            return n >= 2 && pw && lq && q == 1 && inputData._pwDeg == 2;
+        case ENGINE_FAST_L2_L2: return lp && lq && p == 2 && q == 2;
+        case ENGINE_FAST_L2_L2_PARALLEL:
+            return lp && lq && p == 2 && q == 2 && numThreads > 1;
+        case ENGINE_SPARSE: return (lp || huberD) && lq && features._missing;
+        default:
+            return false;
+    }
+}
+
+void KKTSolver::solveAuto(const InputData& inputData, OutputData* result,
+                          int numThreads) {
+    assert(inputData._n >= 1 && inputData._p >= 1 && inputData._q >= 1);
+    assert(result != NULL && numThreads >= 0);
+    if (numThreads == 0) {
+        numThreads = (int)std::thread::hardware_concurrency();
+    }
+    EngineFeatures features;
+    compEngineFeatures(inputData, &features);
+    kkt_engine engine = ENGINE_SOLVE;
+    for (int i = 0; i < _engineRules.size(); ++i) {
+        const KKTEngineRule& rule = _engineRules[i];
+        if (inputData._n >= rule._minN && inputData._n <= rule._maxN &&
+            features._aveBkps <= rule._maxAveBkps &&
+            engineApplies(rule._engine, inputData, features, numThreads)) {
+            engine = rule._engine;
+            break;
+        }
+    }
+    // No engine solves tree inputs outside the solveTree preconditions.
+    assert(inputData._parent == NULL || engine == ENGINE_TREE);
+    result->_engine = engine;
+    switch (engine) {
+        case ENGINE_DP: dp_solve(inputData, result); break;
+        case ENGINE_FAST_L2_L1: fast_l2_l1(inputData, result); break;
+        case ENGINE_CONDAT: condat_l2_l1(inputData, result); break;
+        case ENGINE_TAUT_STRING: taut_string_l2_l1(inputData, result); break;
+        case ENGINE_FAST_L1_L1: fast_l1_l1(inputData, result); break;
+        case ENGINE_FAST_HUBER_L1: fast_huber_l1(inputData, result); break;
+        case ENGINE_FAST_L2_HUBER: fast_l2_huber(inputData, result); break;
+        case ENGINE_FAST_PWL1_L1: fast_pwl1_l1(inputData, result); break;
+        case ENGINE_FAST_PWL2_L1: fast_pwl2_l1(inputData, result); break;
+        case ENGINE_FAST_L2_L2: fast_l2_l2(inputData, result); break;
+        case ENGINE_FAST_L2_L2_PARALLEL:
+            fast_l2_l2_parallel(inputData, result, numThreads);
+            break;
+        case ENGINE_SPARSE: solveSparse(inputData, result); break;
+        case ENGINE_PAV: pav_solve(inputData, result); break;
+        case ENGINE_TREE: solveTree(inputData, result); break;
+        default:
+            result->_engine = ENGINE_SOLVE;
+            solve(inputData, result);
+    }
+}
+
+// Derivative of the deviation function of node i, for LP and HUBER_D.
+static inline data_type devDrvt(const InputData& inputData, int i, data_type x) {
+    data_type c = inputData._cDev[i];
+    data_type diff = x - inputData._aDev[i];
+    if (inputData._deviationType == InputData::HUBER_D) {
+        return c * huberDrvt(diff, inputData._huberD[i]);
+    }
+    data_type drvt = c * Pow(fabs(diff), inputData._p - 1);
+    return diff < 0 ? -drvt : drvt;
+}
+
+// Nodes [_first, _last] pooled at _value.
+struct PAVBlock {
+    int _first, _last;
+    data_type _sumC, _sumCA;  // For quadratic deviations.
+    data_type _sumLinear;  // Separation terms folded in: \sum c_{i-1,i} - c_{i,i+1}.
+    data_type _quadLB, _quadUB;  // Huber: max(a_i - delta_i), min(a_i + delta_i).
+    data_type _value;
+};
+
+// Minimizer of the block's total function within [l, u].
+static data_type pavBlockValue(const InputData& inputData, const PAVBlock& block,
+                               data_type l, data_type u) {
+    bool quadratic = inputData._deviationType == InputData::LP && inputData._p == 2;
+    if (quadratic || inputData._deviationType == InputData::HUBER_D) {
+        data_type x = block._sumC == 0 ?
+            (block._sumLinear > 0 ? -inputData._infinity : inputData._infinity) :
+            (block._sumCA - block._sumLinear) / block._sumC;
+        // Huber blocks are quadratic while every node is within its delta.
+        if (quadratic || (x >= block._quadLB && x <= block._quadUB)) {
+            return x;
+        }
+    }
+    while (u - l >= inputData._solEsp) {
+        data_type x = (l + u) / 2;
+        data_type drvt = block._sumLinear;
+        for (int i = block._first; i <= block._last; ++i) {
+            drvt += devDrvt(inputData, i, x);
+        }
+        if (drvt < 0) {
+            l = x;
+        } else {
+            u = x;
+        }
+    }
+    return (l + u) / 2;
+}
+
+void KKTSolver::pav_solve(const InputData& inputData, OutputData* result) {
+    assert(inputData._n >= 1 && inputData._isotonic && inputData._q == 1);
+    assert(inputData._deviationType == InputData::LP ||
+           inputData._deviationType == InputData::HUBER_D);
+    assert(inputData._separationType == InputData::LQ);
+    assert(result != NULL);
+    int n = inputData._n;
+    std::vector<PAVBlock> blocks;
+    blocks.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        PAVBlock block;
+        block._first = block._last = i;
+        block._sumC = inputData._cDev[i];
+        block._sumCA = inputData._cDev[i] * inputData._aDev[i];
+        block._sumLinear = (i > 0 ? inputData._cSep[i - 1] : 0) -
+            (i < n - 1 ? inputData._cSep[i] : 0);
+        block._quadLB = -inputData._infinity;
+        block._quadUB = inputData._infinity;
+        if (inputData._deviationType == InputData::HUBER_D) {
+            block._quadLB = inputData._aDev[i] - inputData._huberD[i];
+            block._quadUB = inputData._aDev[i] + inputData._huberD[i];
+        }
+        block._value = pavBlockValue(inputData, block, inputData._lb, inputData._ub);
+        // Pool while the previous block violates the order. The pooled value
+        // lies between the two block values.
+        while (!blocks.empty() && blocks.back()._value >= block._value) {
+            const PAVBlock& prev = blocks.back();
+            data_type l = block._value, u = prev._value;
+            block._first = prev._first;
+            block._sumC += prev._sumC;
+            block._sumCA += prev._sumCA;
+            block._sumLinear += prev._sumLinear;
+            block._quadLB = std::max(block._quadLB, prev._quadLB);
+            block._quadUB = std::min(block._quadUB, prev._quadUB);
+            blocks.pop_back();
+            block._value = pavBlockValue(inputData, block, l, u);
+        }
+        blocks.push_back(block);
+    }
+    for (int k = 0; k < blocks.size(); ++k) {
+        data_type x = std::min(std::max(blocks[k]._value, inputData._lb), inputData._ub);
+        for (int i = blocks[k]._first; i <= blocks[k]._last; ++i) {
+            result->_x[i] = x;
+        }
+    }
+}
+
+// Derivative of a forward DP message: A + B * x on each piece. Crossing a
+// breakpoint left to right adds its increment to (A, B).
+struct DPIncrement {
+    data_type _a = 0, _b = 0;
+};
+
+struct DPMessage {
+    data_type _leftA = 0, _leftB = 0;  // Piece before the first breakpoint.
+    data_type _rightA = 0, _rightB = 0;  // Piece after the last breakpoint.
+    std::map<data_type, DPIncrement> _bkps;
+
+    void addBkp(data_type x, data_type a, data_type b) {
+        DPIncrement& inc = _bkps[x];
+        inc._a += a;
+        inc._b += b;
+    }
+};
+
+// Adds the derivative of (c/p)|x - a|^p, p = 1, 2, to the message.
+static void dpAddLpDeviation(int p, data_type c, data_type a, DPMessage* msg) {
+    if (p == 1) {
+        msg->_leftA -= c;
+        msg->_rightA += c;
+        msg->addBkp(a, 2 * c, 0);
+    } else {
+        msg->_leftA -= c * a;
+        msg->_leftB += c;
+        msg->_rightA -= c * a;
+        msg->_rightB += c;
+    }
+}
+
+// Adds the derivative of the deviation function of node i to the message.
+// pwOffset is the start of node i in _pw.
+static void dpAddDeviation(const InputData& inputData, int i, int pwOffset,
+                           DPMessage* msg) {
+    if (inputData._deviationType == InputData::LP) {
+        dpAddLpDeviation(inputData._p, inputData._cDev[i], inputData._aDev[i], msg);
+        return;
+    }
+    // Piece j: coefficients at pw[(pwDeg + 1) * j], breakpoint right after.
+    int pwDeg = inputData._pwDeg;
+    int bkpNum = inputData._bkpNums[i];
+    const data_type* pw = inputData._pw + pwOffset;
+    data_type prevA = 0, prevB = 0;
+    for (int j = 0; j <= bkpNum; ++j) {
+        const data_type* piece = pw + (pwDeg + 1) * j;
+        data_type pieceA = pwDeg == 1 ? piece[0] : -piece[1];
+        data_type pieceB = pwDeg == 1 ? 0 : piece[0];
+        if (j == 0) {
+            msg->_leftA += pieceA;
+            msg->_leftB += pieceB;
+        } else {
+            msg->addBkp(piece[-1], pieceA - prevA, pieceB - prevB);
+        }
+        prevA = pieceA;
+        prevB = pieceB;
+    }
+    msg->_rightA += prevA;
+    msg->_rightB += prevB;
+}
+
+// Clamps the message derivative from below at -w. Returns the point where it
+// reaches -w, or -KKT_INFINITY / KKT_INFINITY if it never is below / above.
+static data_type dpClampLow(data_type w, DPMessage* msg) {
+    data_type a = msg->_leftA, b = msg->_leftB;
+    if (b == 0 && a >= -w) {
+        return -KKT_INFINITY;
+    }
+    data_type t;
+    for (;;) {
+        auto it = msg->_bkps.begin();
+        if (it == msg->_bkps.end() || a + b * it->first >= -w) {
+            // Reaches -w inside the current piece.
+            if (b <= 0) {
+                t = KKT_INFINITY;
+                msg->_rightA = -w;
+                msg->_rightB = 0;
+                msg->_bkps.clear();
+                break;
+            }
+            t = (-w - a) / b;
+            msg->addBkp(t, a + w, b);
+            break;
+        }
+        data_type x = it->first;
+        a += it->second._a;
+        b += it->second._b;
+        msg->_bkps.erase(it);
+        if (msg->_bkps.empty()) {
+            // Exact, free of the rounding in the increments.
+            a = msg->_rightA;
+            b = msg->_rightB;
+        }
+        if (a + b * x >= -w) {
+            // Jumps over -w at the breakpoint.
+            t = x;
+            msg->addBkp(t, a + w, b);
+            break;
+        }
+    }
+    msg->_leftA = -w;
+    msg->_leftB = 0;
+    return t;
+}
+
+// Mirror of dpClampLow: clamps from above at w.
+static data_type dpClampHigh(data_type w, DPMessage* msg) {
+    data_type a = msg->_rightA, b = msg->_rightB;
+    if (b == 0 && a <= w) {
+        return KKT_INFINITY;
+    }
+    data_type t;
+    for (;;) {
+        auto it = msg->_bkps.rbegin();
+        if (it == msg->_bkps.rend() || a + b * it->first <= w) {
+            if (b <= 0) {
+                t = -KKT_INFINITY;
+                msg->_leftA = w;
+                msg->_leftB = 0;
+                msg->_bkps.clear();
+                break;
+            }
+            t = (w - a) / b;
+            msg->addBkp(t, w - a, -b);
+            break;
+        }
+        data_type x = it->first;
+        a -= it->second._a;
+        b -= it->second._b;
+        msg->_bkps.erase(std::next(it).base());
+        if (msg->_bkps.empty()) {
+            a = msg->_leftA;
+            b = msg->_leftB;
+        }
+        if (a + b * x <= w) {
+            t = x;
+            msg->addBkp(t, w - a, -b);
+            break;
+        }
+    }
+    msg->_rightA = w;
+    msg->_rightB = 0;
+    return t;
+}
+
+void KKTSolver::dp_solve(const InputData& inputData, OutputData* result) {
+    assert(inputData._n >= 1 && inputData._q == 1);
+    assert(inputData._separationType == InputData::LQ);
+    assert(inputData._deviationType == InputData::PIECEWISE_LP ||
+           (inputData._deviationType == InputData::LP &&
+            (inputData._p == 1 || inputData._p == 2)));
+    assert(result != NULL);
+    int n = inputData._n;
+    // x_i = clip(x_{i+1}, [lows[i], highs[i]]) in the backward pass.
+    std::vector<data_type> lows(n), highs(n);
+    DPMessage msg;
+    int pwOffset = 0;
+    for (int i = 0; i < n; ++i) {
+        dpAddDeviation(inputData, i, pwOffset, &msg);
         if (inputData._deviationType == InputData::PIECEWISE_LP) {
-            // Move to the next piecewise deviation function.
-            result->_stIndex += (inputData._pwDeg + 1) * inputData._bkpNums[i]
-                                + inputData._pwDeg;
+            pwOffset += (inputData._pwDeg + 1) * inputData._bkpNums[i]
+                        + inputData._pwDeg;
+        }
+        // The last node minimizes its full function: clamp at 0.
+        data_type w = i < n - 1 ? inputData._cSep[i] : 0;
+        lows[i] = dpClampLow(w, &msg);
+        highs[i] = dpClampHigh(w, &msg);
+    }
+    data_type x = lows[n - 1];
+    for (int i = n - 1; i >= 0; --i) {
+        x = std::min(std::max(x, lows[i]), highs[i]);
+        result->_x[i] = std::min(std::max(x, inputData._lb), inputData._ub);
+    }
+}
+
+KKTStream::KKTStream(int p, data_type lb, data_type ub) {
+    assert(p == 1 || p == 2);
+    assert(lb <= ub);
+    _p = p;
+    _lb = lb;
+    _ub = ub;
+    _msg = new DPMessage();
+}
+
+KKTStream::~KKTStream() {
+    delete _msg;
+}
+
+int KKTStream::numBreakpoints() const {
+    return (int)_msg->_bkps.size();
+}
+
+void KKTStream::push(int m, const data_type* cDev, const data_type* aDev,
+                     const data_type* cSep, std::vector<data_type>* out) {
+    assert(m >= 0 && out != NULL);
+    for (int j = 0; j < m; ++j) {
+        if (_hasPending) {
+            _lows.push_back(dpClampLow(_pendingCSep, _msg));
+            _highs.push_back(dpClampHigh(_pendingCSep, _msg));
+        }
+        dpAddLpDeviation(_p, cDev[j], aDev[j], _msg);
+        _hasPending = true;
+        _pendingCSep = cSep[j];
+    }
+    // Range of x_i over all continuations, from the last clamped node down.
+    data_type lo = -KKT_INFINITY, hi = KKT_INFINITY;
+    for (int i = (int)_lows.size() - 1; i >= 0; --i) {
+        lo = std::min(std::max(lo, _lows[i]), _highs[i]);
+        hi = std::min(std::max(hi, _lows[i]), _highs[i]);
+        if (lo == hi) {
+            emit(i, lo, out);
+            break;
+        }
+    }
+}
+
+void KKTStream::finish(std::vector<data_type>* out) {
+    assert(out != NULL);
+    if (_hasPending) {
+        // The last node minimizes its full function: clamp at 0.
+        _lows.push_back(dpClampLow(0, _msg));
+        _highs.push_back(dpClampHigh(0, _msg));
+        emit((int)_lows.size() - 1, _lows.back(), out);
+    }
+    delete _msg;
+    _msg = new DPMessage();
+    _hasPending = false;
+}
+
+void KKTStream::emit(int last, data_type x, std::vector<data_type>* out) {
+    size_t start = out->size();
+    out->resize(start + last + 1);
+    for (int i = last; i >= 0; --i) {
+        x = std::min(std::max(x, _lows[i]), _highs[i]);
+        (*out)[start + i] = std::min(std::max(x, _lb), _ub);
+    }
+    _lows.erase(_lows.begin(), _lows.begin() + last + 1);
+    _highs.erase(_highs.begin(), _highs.begin() + last + 1);
+}
+
+// Adds ${from} into ${to}, inserting the smaller breakpoint map into the larger.
+static void dpMergeMessage(DPMessage* from, DPMessage* to) {
+    if (to->_bkps.size() < from->_bkps.size()) {
+        to->_bkps.swap(from->_bkps);
+    }
+    for (auto it = from->_bkps.begin(); it != from->_bkps.end(); ++it) {
+        to->addBkp(it->first, it->second._a, it->second._b);
+    }
+    from->_bkps.clear();
+    to->_leftA += from->_leftA;
+    to->_leftB += from->_leftB;
+    to->_rightA += from->_rightA;
+    to->_rightB += from->_rightB;
+}
+
+void KKTSolver::solveTree(const InputData& inputData, OutputData* result) {
+    assert(inputData._n >= 1 && inputData._q == 1 && inputData._parent != NULL);
+    assert(inputData._separationType == InputData::LQ);
+    assert(inputData._deviationType == InputData::PIECEWISE_LP ||
+           (inputData._deviationType == InputData::LP &&
+            (inputData._p == 1 || inputData._p == 2)));
+    assert(result != NULL);
+    int n = inputData._n;
+    std::vector<int> pwOffsets(n, 0);
+    if (inputData._deviationType == InputData::PIECEWISE_LP) {
+        for (int i = 0; i < n - 1; ++i) {
+            pwOffsets[i + 1] = pwOffsets[i] + (inputData._pwDeg + 1) *
+                inputData._bkpNums[i] + inputData._pwDeg;
+        }
+    }
+    // x_v = clip(x_{parent}, [lows[v], highs[v]]) in the top-down pass.
+    std::vector<data_type> lows(n), highs(n);
+    std::vector<DPMessage> msgs(n);
+    // Children have larger indices: reverse index order is a post-order.
+    for (int v = n - 1; v >= 0; --v) {
+        dpAddDeviation(inputData, v, pwOffsets[v], &msgs[v]);
+        for (int k = inputData._childStart[v]; k < inputData._childStart[v + 1]; ++k) {
+            dpMergeMessage(&msgs[inputData._children[k]], &msgs[v]);
         }
+        // The root minimizes its full function: clamp at 0.
+        data_type w = v > 0 ? inputData._cSep[v - 1] : 0;
+        lows[v] = dpClampLow(w, &msgs[v]);
+        highs[v] = dpClampHigh(w, &msgs[v]);
+    }
+    std::vector<data_type> x(n);
+    x[0] = lows[0];
+    for (int v = 0; v < n; ++v) {
+        data_type anchor = v > 0 ? x[inputData._parent[v]] : x[0];
+        x[v] = std::min(std::max(anchor, lows[v]), highs[v]);
+        result->_x[v] = std::min(std::max(x[v], inputData._lb), inputData._ub);
     }
 }
 
@@ -352,42 +1039,47 @@ static inline int getStIndex(const std::vector<int>& boundIndex) {
     }
 }
 
-void KKTSolver::fast_l2_l1(const InputData &inputData, OutputData *result) {
-    assert(inputData._n >= 2 && inputData._p == 2 && inputData._q == 1);
-    assert(result != NULL);
-
-    int n = inputData._n;
+// The propagation of fast_l2_l1 on raw arrays, with the search interval of
+// node i from bounds(i, &l, &u). Heap-free, for the small-problem entry
+// points; FixedN > 0 fixes n at compile time.
+template <int FixedN, typename Bounds>
+static void l2l1Kernel(int n, const data_type* cDev, const data_type* aDev,
+                       const data_type* cSep, Bounds bounds, data_type solEsp,
+                       data_type* x) {
+    if (FixedN > 0) {
+        n = FixedN;
+    }
     int i = 0;
     while (i < n) {
-        std::vector<int> boundIndex(2, i);
-        std::vector<data_type> accuDrvtCoeff(2, inputData._cDev[i]);
-        std::vector<data_type> accuDrvtConst(2, -inputData._cDev[i] * inputData._aDev[i]);
-        data_type l = result->_bounds[i][0];
-        data_type u = result->_bounds[i][1];
-        result->_x[i] = (l + u) / 2;
-        while (u - l >= inputData._solEsp) {
-            int binIndex = getStIndex(boundIndex);
+        int boundIndex[2] = {i, i};
+        data_type accuDrvtCoeff[2] = {cDev[i], cDev[i]};
+        data_type accuDrvtConst[2] = {-cDev[i] * aDev[i], -cDev[i] * aDev[i]};
+        data_type l, u;
+        bounds(i, &l, &u);
+        x[i] = (l + u) / 2;
+        while (u - l >= solEsp) {
+            int binIndex = boundIndex[0] <= boundIndex[1] ? 0 : 1;
             int stIndex = boundIndex[binIndex];
             data_type drvtCoeff = accuDrvtCoeff[binIndex];
             data_type drvtConst = accuDrvtConst[binIndex];
             data_type l1Const = 0;
             if (i > 0) {
                 // Include previous slope
-                l1Const = l1Slope(result->_x[i], result->_x[i - 1], inputData._cSep[i - 1]);
+                l1Const = l1Slope(x[i], x[i - 1], cSep[i - 1]);
             }
-            data_type drvtValue = drvtCoeff * result->_x[i] + drvtConst + l1Const;
+            data_type drvtValue = drvtCoeff * x[i] + drvtConst + l1Const;
             // +1: Go down; -1: Go up.
             int direction = drvtValue >= 0 ? 1 : -1;
             // Propagation
             while (stIndex < n - 1) {
                 // Propagate
                 if (drvtValue >= 0) {
-                    if (drvtValue < inputData._cSep[stIndex]) {
+                    if (drvtValue < cSep[stIndex]) {
                         // Propagate success
-                        drvtCoeff += inputData._cDev[stIndex + 1];
-                        drvtConst += -inputData._cDev[stIndex + 1] * inputData._aDev[stIndex + 1];
+                        drvtCoeff += cDev[stIndex + 1];
+                        drvtConst += -cDev[stIndex + 1] * aDev[stIndex + 1];
                         stIndex++;
-                        drvtValue = drvtCoeff * result->_x[i] + drvtConst + l1Const;
+                        drvtValue = drvtCoeff * x[i] + drvtConst + l1Const;
                     } else {
                         // Propagate failed, upper bound exceeded
                         // Update the data structures
@@ -398,12 +1090,12 @@ void KKTSolver::fast_l2_l1(const InputData &inputData, OutputData *result) {
                         break;
                     }
                 } else {
-                    if (-drvtValue <= inputData._cSep[stIndex]) {
+                    if (-drvtValue <= cSep[stIndex]) {
                         // Propagate success
-                        drvtCoeff += inputData._cDev[stIndex + 1];
-                        drvtConst += -inputData._cDev[stIndex + 1] * inputData._aDev[stIndex + 1];
+                        drvtCoeff += cDev[stIndex + 1];
+                        drvtConst += -cDev[stIndex + 1] * aDev[stIndex + 1];
                         stIndex++;
-                        drvtValue = drvtCoeff * result->_x[i] + drvtConst + l1Const;
+                        drvtValue = drvtCoeff * x[i] + drvtConst + l1Const;
                     } else {
                         // Propagate failed, lower bound exceeded
                         // Update the data structures
@@ -433,35 +1125,2078 @@ void KKTSolver::fast_l2_l1(const InputData &inputData, OutputData *result) {
 
             // Find the next search value.
             if (direction == -1) {
-                l = result->_x[i];
+                l = x[i];
             } else {
-                u = result->_x[i];
+                u = x[i];
             }
-            result->_x[i] = (l + u) / 2;
+            x[i] = (l + u) / 2;
         }
-        int binIndex = getStIndex(boundIndex);
-        int stIndex = boundIndex[binIndex];
+        int stIndex = boundIndex[boundIndex[0] <= boundIndex[1] ? 0 : 1];
         for (int j = i + 1; j <= stIndex; ++j) {
-            result->_x[j] = result->_x[i];
+            x[j] = x[i];
         }
         i = stIndex + 1;
     }
 }
 
-void KKTSolver::fast_linear_l2(const InputData &inputData, OutputData *result) {
-    assert(inputData._n >= 2 && inputData._p == 1 && inputData._q == 2);
+// Uniform search intervals of l2l1Kernel.
+struct UniformBounds {
+    data_type _lb, _ub;
+    void operator () (int /*i*/, data_type* l, data_type* u) const {
+        *l = _lb;
+        *u = _ub;
+    }
+};
+
+void KKTSolver::fast_l2_l1(const InputData &inputData, OutputData *result) {
+    assert(inputData._n >= 2 && inputData._p == 2 && inputData._q == 1);
+    assert(result != NULL);
+    auto bounds = [&](int i, data_type* l, data_type* u) {
+        *l = result->_bounds[i][0];
+        *u = result->_bounds[i][1];
+    };
+    l2l1Kernel<0>(inputData._n, inputData._cDev, inputData._aDev, inputData._cSep,
+                  bounds, inputData._solEsp, result->_x);
+}
+
+void KKTSolver::fast_l2_l1(int n, const data_type* cDev, const data_type* aDev,
+                           const data_type* cSep, data_type lb, data_type ub,
+                           data_type solEsp, data_type* x) {
+    assert(n >= 1 && x != NULL);
+    UniformBounds bounds = {lb, ub};
+    l2l1Kernel<0>(n, cDev, aDev, cSep, bounds, solEsp, x);
+}
+
+void KKTSolver::fast_l2_l1(KKTWorkspace* workspace) {
+    assert(workspace != NULL);
+    workspace->restart();
+    fast_l2_l1(workspace->input(), &workspace->output());
+}
+
+template <int N>
+void KKTSolver::fast_l2_l1_fixed(const data_type* cDev, const data_type* aDev,
+                                 const data_type* cSep, data_type lb, data_type ub,
+                                 data_type solEsp, data_type* x) {
+    UniformBounds bounds = {lb, ub};
+    l2l1Kernel<N>(N, cDev, aDev, cSep, bounds, solEsp, x);
+}
+
+// The compile-time sizes of fast_l2_l1_fixed.
+#define KKT_INSTANTIATE_FIXED(N) \
+    template void KKTSolver::fast_l2_l1_fixed<N>( \
+        const data_type*, const data_type*, const data_type*, \
+        data_type, data_type, data_type, data_type*);
+KKT_INSTANTIATE_FIXED(8)
+KKT_INSTANTIATE_FIXED(16)
+KKT_INSTANTIATE_FIXED(32)
+KKT_INSTANTIATE_FIXED(64)
+KKT_INSTANTIATE_FIXED(128)
+KKT_INSTANTIATE_FIXED(256)
+KKT_INSTANTIATE_FIXED(512)
+KKT_INSTANTIATE_FIXED(1024)
+#undef KKT_INSTANTIATE_FIXED
+
+static inline data_type clip(data_type x, data_type lb, data_type ub) {
+    return x < lb ? lb : (x > ub ? ub : x);
+}
+
+void KKTSolver::condat_l2_l1(const InputData &inputData, OutputData *result) {
+    assert(inputData._p == 2 && inputData._q == 1);
     assert(result != NULL);
-    data_type linCoeffSum = 0;
     int n = inputData._n;
-    for (int i = 0; i < n; ++i) {
-        linCoeffSum += inputData._cDev[i];
+    const data_type* a = inputData._aDev;
+    data_type* x = result->_x;
+    if (n == 1) {
+        x[0] = clip(a[0], inputData._lb, inputData._ub);
+        return;
     }
-    assert(fabs(linCoeffSum) < 1e-6);
+    for (int i = 1; i < n; ++i) {
+        assert(inputData._cDev[i] == inputData._cDev[0]);
+    }
+    for (int i = 1; i < n - 1; ++i) {
+        assert(inputData._cSep[i] == inputData._cSep[0]);
+    }
+    // Dividing through by the uniform deviation weight.
+    data_type lambda = inputData._cSep[0] / inputData._cDev[0];
+    data_type twoLambda = 2 * lambda;
+    data_type minLambda = -lambda;
+
+    int k = 0, k0 = 0;  // Current node, start of the current segment.
+    int kPlus = 0, kMinus = 0;  // Last nodes where uMax = -lambda, uMin = lambda.
+    data_type uMin = lambda, uMax = minLambda;  // Dual variable bounds.
+    data_type vMin = a[0] - lambda, vMax = a[0] + lambda;  // Segment value bounds.
+    for (;;) {
+        while (k == n - 1) {
+            // Right boundary.
+            if (uMin < 0) {
+                do x[k0++] = vMin; while (k0 <= kMinus);
+                k = kMinus = k0;
+                vMin = a[k];
+                uMin = lambda;
+                uMax = vMin + uMin - vMax;
+            } else if (uMax > 0) {
+                do x[k0++] = vMax; while (k0 <= kPlus);
+                k = kPlus = k0;
+                vMax = a[k];
+                uMax = minLambda;
+                uMin = vMax + uMax - vMin;
+            } else {
+                vMin += uMin / (k - k0 + 1);
+                do x[k0++] = vMin; while (k0 <= k);
+                for (int i = 0; i < n; ++i) {
+                    x[i] = clip(x[i], inputData._lb, inputData._ub);
+                }
+                return;
+            }
+        }
+        if ((uMin += a[k + 1] - vMin) < minLambda) {
+            // Negative jump.
+            do x[k0++] = vMin; while (k0 <= kMinus);
+            k = kPlus = kMinus = k0;
+            vMin = a[k];
+            vMax = vMin + twoLambda;
+            uMin = lambda;
+            uMax = minLambda;
+        } else if ((uMax += a[k + 1] - vMax) > lambda) {
+            // Positive jump.
+            do x[k0++] = vMax; while (k0 <= kPlus);
+            k = kPlus = kMinus = k0;
+            vMax = a[k];
+            vMin = vMax - twoLambda;
+            uMin = lambda;
+            uMax = minLambda;
+        } else {
+            ++k;
+            if (uMin >= lambda) {
+                kMinus = k;
+                vMin += (uMin - lambda) / (kMinus - k0 + 1);
+                uMin = lambda;
+            }
+            if (uMax <= minLambda) {
+                kPlus = k;
+                vMax += (uMax + lambda) / (kPlus - k0 + 1);
+                uMax = minLambda;
+            }
+        }
+    }
+}
+
+static inline int sign(data_type value) {
+    return (value > 0) - (value < 0);
+}
+
+// Lambda at which adjacent segments ${left} and ${right} meet, from ${lambda}
+// on; KKT_INFINITY if they do not approach. ${order} = sign(left - right) as
+// tracked by the path, which rounding in the gap must not flip.
+static data_type pathMeet(const L2L1PathNode& left, const L2L1PathNode& right,
+                          int order, data_type lambda) {
+    if (order == 0) {
+        return lambda;
+    }
+    data_type gap = (left._alpha - left._beta * lambda) -
+        (right._alpha - right._beta * lambda);
+    data_type rate = left._beta - right._beta;  // Rate at which the gap closes.
+    if (order * rate <= 0) {
+        return KKT_INFINITY;
+    }
+    return lambda + (order * gap > 0 ? gap / rate : 0);
+}
 
-    result->_x[0] = 0;
-    linCoeffSum = 0;
+void KKTSolver::l2_l1_path(const InputData& inputData, L2L1Path* path) {
+    assert(inputData._deviationType == InputData::LP && inputData._p == 2);
+    assert(inputData._separationType == InputData::LQ && inputData._q == 1);
+    assert(path != NULL);
+    int n = inputData._n;
+    path->_n = n;
+    path->_lb = inputData._lb;
+    path->_ub = inputData._ub;
+    path->_nodes.clear();
+    path->_nodes.reserve(2 * n - 1);
+    path->_roots.clear();
+    // Per segment: \sum c_i, \sum c_ia_i, and the signs of its value against
+    // the left / right neighbor; the value is (sumCA - lambda(sL + sR)) / sumC.
+    std::vector<data_type> sumC(2 * n - 1), sumCA(2 * n - 1);
+    std::vector<int> signL(2 * n - 1), signR(2 * n - 1);
+    // Neighbors of the live segments.
+    std::vector<int> prev(2 * n - 1), next(2 * n - 1);
+    for (int i = 0; i < n; ++i) {
+        assert(inputData._cDev[i] > 0);
+        sumC[i] = inputData._cDev[i];
+        sumCA[i] = inputData._cDev[i] * inputData._aDev[i];
+        signL[i] = i > 0 ? sign(inputData._aDev[i] - inputData._aDev[i - 1]) : 0;
+        signR[i] = i < n - 1 ? sign(inputData._aDev[i] - inputData._aDev[i + 1]) : 0;
+        prev[i] = i - 1;
+        next[i] = i < n - 1 ? i + 1 : -1;
+        L2L1PathNode node;
+        node._first = node._last = i;
+        node._birth = 0;
+        node._death = KKT_INFINITY;
+        node._alpha = inputData._aDev[i];
+        node._beta = (data_type)(signL[i] + signR[i]) / sumC[i];
+        node._left = node._right = -1;
+        path->_nodes.push_back(node);
+    }
+    // Candidate merges (lambda, left segment, right segment); stale once
+    // either segment has merged.
+    typedef std::pair<data_type, std::pair<int, int>> PathEvent;
+    std::vector<PathEvent> initEvents;
     for (int i = 0; i < n - 1; ++i) {
-        linCoeffSum += inputData._cDev[i];
-        result->_x[i + 1] = result->_x[i] + linCoeffSum;
+        data_type meet = pathMeet(path->_nodes[i], path->_nodes[i + 1], signR[i], 0);
+        if (meet < KKT_INFINITY) {
+            initEvents.push_back(PathEvent(meet, std::make_pair(i, i + 1)));
+        }
+    }
+    // Heapified in O(n).
+    std::priority_queue<PathEvent, std::vector<PathEvent>, std::greater<PathEvent>>
+        events(std::greater<PathEvent>(), std::move(initEvents));
+    while (!events.empty()) {
+        data_type lambda = events.top().first;
+        int s = events.top().second.first;
+        int t = events.top().second.second;
+        events.pop();
+        if (path->_nodes[s]._death < KKT_INFINITY || path->_nodes[t]._death < KKT_INFINITY) {
+            continue;
+        }
+        int m = (int)path->_nodes.size();
+        path->_nodes[s]._death = lambda;
+        path->_nodes[t]._death = lambda;
+        sumC[m] = sumC[s] + sumC[t];
+        sumCA[m] = sumCA[s] + sumCA[t];
+        signL[m] = signL[s];
+        signR[m] = signR[t];
+        prev[m] = prev[s];
+        next[m] = next[t];
+        if (prev[m] >= 0) {
+            next[prev[m]] = m;
+        }
+        if (next[m] >= 0) {
+            prev[next[m]] = m;
+        }
+        L2L1PathNode node;
+        node._first = path->_nodes[s]._first;
+        node._last = path->_nodes[t]._last;
+        node._birth = lambda;
+        node._death = KKT_INFINITY;
+        node._alpha = sumCA[m] / sumC[m];
+        node._beta = (data_type)(signL[m] + signR[m]) / sumC[m];
+        node._left = s;
+        node._right = t;
+        path->_nodes.push_back(node);
+        if (prev[m] >= 0) {
+            data_type meet = pathMeet(path->_nodes[prev[m]], node, signR[prev[m]], lambda);
+            if (meet < KKT_INFINITY) {
+                events.push(PathEvent(meet, std::make_pair(prev[m], m)));
+            }
+        }
+        if (next[m] >= 0) {
+            data_type meet = pathMeet(node, path->_nodes[next[m]], signR[m], lambda);
+            if (meet < KKT_INFINITY) {
+                events.push(PathEvent(meet, std::make_pair(m, next[m])));
+            }
+        }
+    }
+    for (int k = 0; k < path->_nodes.size(); ++k) {
+        if (path->_nodes[k]._death == KKT_INFINITY && path->_nodes[k]._first == 0) {
+            for (int r = k; r >= 0; r = next[r]) {
+                path->_roots.push_back(r);
+            }
+            break;
+        }
+    }
+}
+
+void L2L1Path::segments(data_type lambda, std::vector<int>* out) const {
+    assert(lambda >= 0 && out != NULL);
+    out->clear();
+    // Depth-first from the roots, right child pushed first.
+    std::vector<int> stack(_roots.rbegin(), _roots.rend());
+    while (!stack.empty()) {
+        int k = stack.back();
+        stack.pop_back();
+        const L2L1PathNode& node = _nodes[k];
+        if (node._birth <= lambda || node._left < 0) {
+            out->push_back(k);
+        } else {
+            stack.push_back(node._right);
+            stack.push_back(node._left);
+        }
+    }
+}
+
+void L2L1Path::solution(data_type lambda, OutputData* result) const {
+    assert(result != NULL && result->_n == _n);
+    std::vector<int> segs;
+    segments(lambda, &segs);
+    for (int s = 0; s < segs.size(); ++s) {
+        const L2L1PathNode& node = _nodes[segs[s]];
+        data_type value = node._alpha - node._beta * lambda;
+        value = std::min(std::max(value, _lb), _ub);
+        for (int i = node._first; i <= node._last; ++i) {
+            result->_x[i] = value;
+        }
+    }
+}
+
+// A vertex of the taut string: node index k, abscissa \sum_{i<k} c_i and
+// ordinate R_k.
+struct TautPoint {
+    int _k;
+    data_type _t, _r;
+};
+
+static inline data_type tautSlope(const TautPoint& from, const TautPoint& to) {
+    return (to._r - from._r) / (to._t - from._t);
+}
+
+// Fixes the string from the anchor to the next vertex: nodes in between take
+// the slope of the segment.
+static inline void tautEmit(TautPoint* anchor, const TautPoint& to, data_type* x) {
+    data_type slope = tautSlope(*anchor, to);
+    for (int i = anchor->_k; i < to._k; ++i) {
+        x[i] = slope;
+    }
+    *anchor = to;
+}
+
+void KKTSolver::taut_string_l2_l1(const InputData &inputData, OutputData *result) {
+    assert(inputData._p == 2 && inputData._q == 1);
+    assert(result != NULL);
+    int n = inputData._n;
+    const data_type* c = inputData._cDev;
+    const data_type* a = inputData._aDev;
+    data_type* x = result->_x;
+
+    // Concave chain over the lower tube and convex chain under the upper tube,
+    // both starting at the anchor. Front pops advance the head index.
+    std::vector<TautPoint> lower, upper;
+    lower.reserve(n);
+    upper.reserve(n);
+    int lowerHead = 0, upperHead = 0;
+    TautPoint anchor = {0, 0, 0};
+    data_type t = 0, sumCA = 0;
+    for (int k = 1; k <= n; ++k) {
+        assert(c[k - 1] > 0);
+        t += c[k - 1];
+        sumCA += c[k - 1] * a[k - 1];
+        data_type width = k < n ? inputData._cSep[k - 1] : 0;
+        TautPoint l = {k, t, sumCA - width};
+        TautPoint u = {k, t, sumCA + width};
+
+        while (lower.size() > lowerHead) {
+            const TautPoint& prev = lower.size() - lowerHead >= 2 ?
+                lower[lower.size() - 2] : anchor;
+            if (tautSlope(prev, lower.back()) > tautSlope(prev, l)) {
+                break;
+            }
+            lower.pop_back();
+        }
+        lower.push_back(l);
+        // The string is pushed up against the upper tube.
+        while (upper.size() > upperHead &&
+               tautSlope(anchor, lower[lowerHead]) > tautSlope(anchor, upper[upperHead])) {
+            tautEmit(&anchor, upper[upperHead++], x);
+        }
+
+        while (upper.size() > upperHead) {
+            const TautPoint& prev = upper.size() - upperHead >= 2 ?
+                upper[upper.size() - 2] : anchor;
+            if (tautSlope(prev, upper.back()) < tautSlope(prev, u)) {
+                break;
+            }
+            upper.pop_back();
+        }
+        upper.push_back(u);
+        // The string is pulled down against the lower tube.
+        while (lower.size() > lowerHead &&
+               tautSlope(anchor, upper[upperHead]) < tautSlope(anchor, lower[lowerHead])) {
+            tautEmit(&anchor, lower[lowerHead++], x);
+        }
+    }
+    // Both chains end at (\sum c_i, \sum c_ia_i); at most one has interior vertices.
+    if (lower.size() - lowerHead > 1) {
+        while (lowerHead < lower.size()) {
+            tautEmit(&anchor, lower[lowerHead++], x);
+        }
+    } else {
+        while (upperHead < upper.size()) {
+            tautEmit(&anchor, upper[upperHead++], x);
+        }
+    }
+    for (int i = 0; i < n; ++i) {
+        x[i] = clip(x[i], inputData._lb, inputData._ub);
+    }
+}
+
+// Right sub-derivative of c * |x - a|, consistent with compDrvt.
+static inline data_type l1DevDrvt(data_type x, data_type a, data_type c) {
+    return x >= a ? c : -c;
+}
+
+void KKTSolver::fast_l1_l1(const InputData &inputData, OutputData *result) {
+    assert(inputData._n >= 2 && inputData._p == 1 && inputData._q == 1);
+    assert(inputData._deviationType == InputData::LP &&
+           inputData._separationType == InputData::LQ);
+    assert(result != NULL);
+
+    int n = inputData._n;
+    int i = 0;
+    // Nodes with aDev in (l, u], whose derivative sign depends on x.
+    std::vector<std::vector<int>> accuUndIndex(2);
+    std::vector<int> undIndex;
+    std::vector<data_type> bkps;
+    while (i < n) {
+        std::vector<int> boundIndex(2, i);
+        // Sum of derivatives of nodes whose sign is fixed over [l, u].
+        std::vector<data_type> accuDrvtConst(2, 0);
+        for (int b = 0; b < 2; ++b) {
+            accuUndIndex[b].clear();
+            accuUndIndex[b].push_back(i);
+        }
+        data_type l = result->_bounds[i][0];
+        data_type u = result->_bounds[i][1];
+        result->_x[i] = (l + u) / 2;
+        while (u - l >= inputData._solEsp) {
+            int binIndex = getStIndex(boundIndex);
+            int stIndex = boundIndex[binIndex];
+            data_type drvtConst = accuDrvtConst[binIndex];
+            data_type x = result->_x[i];
+            data_type drvtValue = 0;
+            // Settle the nodes that the shrunk interval has determined.
+            undIndex.clear();
+            const std::vector<int>& prevUndIndex = accuUndIndex[binIndex];
+            for (int k = 0; k < prevUndIndex.size(); ++k) {
+                int j = prevUndIndex[k];
+                data_type a = inputData._aDev[j];
+                if (a <= l) {
+                    drvtConst += inputData._cDev[j];
+                } else if (a > u) {
+                    drvtConst -= inputData._cDev[j];
+                } else {
+                    undIndex.push_back(j);
+                    drvtValue += l1DevDrvt(x, a, inputData._cDev[j]);
+                }
+            }
+            data_type l1Const = 0;
+            if (i > 0) {
+                // Include previous slope, with the same right sub-derivative as
+                // the deviations so that the pieces below are [bkpL, bkpR).
+                l1Const = l1DevDrvt(x, result->_x[i - 1], inputData._cSep[i - 1]);
+            }
+            drvtValue += drvtConst + l1Const;
+            // +1: Go down; -1: Go up.
+            int direction = drvtValue >= 0 ? 1 : -1;
+            // Propagation
+            while (stIndex < n - 1) {
+                bool success = drvtValue >= 0 ?
+                    drvtValue < inputData._cSep[stIndex] :
+                    -drvtValue <= inputData._cSep[stIndex];
+                if (!success) {
+                    // Propagate failed, bound exceeded
+                    direction = drvtValue >= 0 ? 1 : -1;
+                    break;
+                }
+                // Propagate success
+                int j = stIndex + 1;
+                data_type a = inputData._aDev[j];
+                if (a <= l) {
+                    drvtConst += inputData._cDev[j];
+                } else if (a > u) {
+                    drvtConst -= inputData._cDev[j];
+                } else {
+                    undIndex.push_back(j);
+                }
+                drvtValue += l1DevDrvt(x, a, inputData._cDev[j]);
+                stIndex++;
+            }
+
+            if (stIndex == n - 1) {
+                // Reach the end, no early stopping.
+                direction = drvtValue >= 0 ? 1 : -1;
+            }
+            // Update the data structures
+            int dirIndex = direction == 1 ? 1 : 0;
+            boundIndex[dirIndex] = stIndex;
+            accuDrvtConst[dirIndex] = drvtConst;
+            accuUndIndex[dirIndex].swap(undIndex);
+
+            // The derivative is piecewise constant in x, changing only at the
+            // breakpoints of the propagated chain (its aDev's and x_{i-1}).
+            // The probe outcome holds on the whole piece [bkpL, bkpR) around x,
+            // so the search interval shrinks to the breakpoints directly.
+            data_type bkpL = l, bkpR = u;
+            if (i > 0) {
+                data_type a = result->_x[i - 1];
+                if (a <= x && a > bkpL) bkpL = a;
+                if (a > x && a < bkpR) bkpR = a;
+            }
+            const std::vector<int>& lastUndIndex = accuUndIndex[dirIndex];
+            for (int k = 0; k < lastUndIndex.size(); ++k) {
+                data_type a = inputData._aDev[lastUndIndex[k]];
+                if (a <= x && a > bkpL) bkpL = a;
+                if (a > x && a < bkpR) bkpR = a;
+            }
+            if (direction == -1) {
+                l = bkpR;
+            } else {
+                u = bkpL;
+            }
+            // Find the next search value: split the remaining breakpoints
+            // of the last chain in half, or bisect if there are none.
+            bkps.clear();
+            if (i > 0 && result->_x[i - 1] > l && result->_x[i - 1] < u) {
+                bkps.push_back(result->_x[i - 1]);
+            }
+            for (int k = 0; k < lastUndIndex.size(); ++k) {
+                data_type a = inputData._aDev[lastUndIndex[k]];
+                if (a > l && a < u) bkps.push_back(a);
+            }
+            result->_x[i] = (l + u) / 2;
+            if (!bkps.empty()) {
+                std::vector<data_type>::iterator mid = bkps.begin() + bkps.size() / 2;
+                std::nth_element(bkps.begin(), mid, bkps.end());
+                data_type next = u;
+                for (std::vector<data_type>::iterator it = mid + 1; it != bkps.end(); ++it) {
+                    if (*it > *mid && *it < next) next = *it;
+                }
+                result->_x[i] = (*mid + next) / 2;
+            }
+        }
+        int binIndex = getStIndex(boundIndex);
+        int stIndex = boundIndex[binIndex];
+        for (int j = i + 1; j <= stIndex; ++j) {
+            result->_x[j] = result->_x[i];
+        }
+        i = stIndex + 1;
+    }
+}
+
+// Accumulate the derivative of c * huber_k(x - a) into drvtCoeff * x + drvtConst
+// if its regime is the same for all x in (l, u). Return false otherwise.
+static inline bool settleHuber(data_type a, data_type c, data_type k,
+                               data_type l, data_type u,
+                               data_type* drvtCoeff, data_type* drvtConst) {
+    if (a + k <= l) {
+        *drvtConst += c * k;
+    } else if (a - k >= u) {
+        *drvtConst -= c * k;
+    } else if (a - k <= l && a + k >= u) {
+        *drvtCoeff += c;
+        *drvtConst -= c * a;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+void KKTSolver::fast_huber_l1(const InputData &inputData, OutputData *result) {
+    assert(inputData._n >= 2 && inputData._q == 1);
+    assert(inputData._deviationType == InputData::HUBER_D &&
+           inputData._separationType == InputData::LQ);
+    assert(result != NULL);
+
+    int n = inputData._n;
+    int i = 0;
+    // Nodes whose Huber regime is not settled by the search interval.
+    std::vector<std::vector<int>> accuUndIndex(2);
+    std::vector<int> undIndex;
+    while (i < n) {
+        std::vector<int> boundIndex(2, i);
+        std::vector<data_type> accuDrvtCoeff(2, 0);
+        std::vector<data_type> accuDrvtConst(2, 0);
+        for (int b = 0; b < 2; ++b) {
+            accuUndIndex[b].clear();
+            accuUndIndex[b].push_back(i);
+        }
+        data_type l = result->_bounds[i][0];
+        data_type u = result->_bounds[i][1];
+        result->_x[i] = (l + u) / 2;
+        while (u - l >= inputData._solEsp) {
+            int binIndex = getStIndex(boundIndex);
+            int stIndex = boundIndex[binIndex];
+            data_type drvtCoeff = accuDrvtCoeff[binIndex];
+            data_type drvtConst = accuDrvtConst[binIndex];
+            data_type x = result->_x[i];
+            data_type undDrvtValue = 0;
+            // Settle the nodes that the shrunk interval has determined.
+            undIndex.clear();
+            const std::vector<int>& prevUndIndex = accuUndIndex[binIndex];
+            for (int k = 0; k < prevUndIndex.size(); ++k) {
+                int j = prevUndIndex[k];
+                data_type a = inputData._aDev[j];
+                data_type c = inputData._cDev[j];
+                data_type delta = inputData._huberD[j];
+                if (!settleHuber(a, c, delta, l, u, &drvtCoeff, &drvtConst)) {
+                    undIndex.push_back(j);
+                    undDrvtValue += c * huberDrvt(x - a, delta);
+                }
+            }
+            data_type l1Const = 0;
+            if (i > 0) {
+                // Include previous slope
+                l1Const = l1Slope(x, result->_x[i - 1], inputData._cSep[i - 1]);
+            }
+            data_type drvtValue = drvtCoeff * x + drvtConst + undDrvtValue + l1Const;
+            // +1: Go down; -1: Go up.
+            int direction = drvtValue >= 0 ? 1 : -1;
+            // Propagation
+            while (stIndex < n - 1) {
+                bool success = drvtValue >= 0 ?
+                    drvtValue < inputData._cSep[stIndex] :
+                    -drvtValue <= inputData._cSep[stIndex];
+                if (!success) {
+                    // Propagate failed, bound exceeded
+                    direction = drvtValue >= 0 ? 1 : -1;
+                    break;
+                }
+                // Propagate success
+                int j = stIndex + 1;
+                data_type a = inputData._aDev[j];
+                data_type c = inputData._cDev[j];
+                data_type delta = inputData._huberD[j];
+                if (settleHuber(a, c, delta, l, u, &drvtCoeff, &drvtConst)) {
+                    drvtValue = drvtCoeff * x + drvtConst + undDrvtValue + l1Const;
+                } else {
+                    undIndex.push_back(j);
+                    data_type drvtDelta = c * huberDrvt(x - a, delta);
+                    undDrvtValue += drvtDelta;
+                    drvtValue += drvtDelta;
+                }
+                stIndex++;
+            }
+
+            if (stIndex == n - 1) {
+                // Reach the end, no early stopping.
+                direction = drvtValue >= 0 ? 1 : -1;
+            }
+            // Update the data structures
+            int dirIndex = direction == 1 ? 1 : 0;
+            boundIndex[dirIndex] = stIndex;
+            accuDrvtCoeff[dirIndex] = drvtCoeff;
+            accuDrvtConst[dirIndex] = drvtConst;
+            accuUndIndex[dirIndex].swap(undIndex);
+
+            // Find the next search value.
+            if (direction == -1) {
+                l = result->_x[i];
+            } else {
+                u = result->_x[i];
+            }
+            result->_x[i] = (l + u) / 2;
+        }
+        int binIndex = getStIndex(boundIndex);
+        int stIndex = boundIndex[binIndex];
+        for (int j = i + 1; j <= stIndex; ++j) {
+            result->_x[j] = result->_x[i];
+        }
+        i = stIndex + 1;
+    }
+}
+
+// Propagation of fast_l2_huber, specialized from propagate().
+// Return type: +1: Go down; 0, depending on out_drvtValue; -1: Go up.
+static int propagateL2Huber(const InputData& inputData, OutputData* outputData,
+                            int index, data_type* out_drvtValue) {
+    int n = inputData._n;
+    data_type* x = outputData->_x;
+    NodeBounds& bounds = outputData->_bounds;
+    data_type drvtValue = inputData._cDev[index] * (x[index] - inputData._aDev[index]);
+    if (index > 0) {
+        drvtValue += inputData._cSep[index - 1] *
+            huberDrvt(x[index] - x[index - 1], inputData._huberS[index - 1]);
+    }
+
+    int state = 0;
+    int i = index;
+    for (; i < n - 1; ++i) {
+        data_type cSep = inputData._cSep[i];
+        data_type delta = cSep * inputData._huberS[i];
+        if (drvtValue < -delta) {
+            // Inverse is -infinity.
+            state = -1;
+            break;
+        }
+        if (drvtValue >= delta) {
+            // Inverse is +infinity.
+            state = 1;
+            break;
+        }
+        x[i + 1] = x[i] + drvtValue / cSep;
+        if (x[i + 1] < bounds[i + 1][0]) {
+            state = -1;
+            break;
+        }
+        if (x[i + 1] > bounds[i + 1][1]) {
+            state = 1;
+            break;
+        }
+        drvtValue += inputData._cDev[i + 1] * (x[i + 1] - inputData._aDev[i + 1]);
+    }
+    *out_drvtValue = drvtValue;
+
+    int end = i + 1;
+    if (state == 0) {
+        if (drvtValue > 0) {
+            state = 1;
+        } else if (drvtValue < 0) {
+            state = -1;
+        }
+        end = n;
+        if (state == 0) return 0;
+    }
+    if (state < 0) {
+        // New lower divergence bound
+        for (int j = index; j < end; ++j) {
+            bounds[j][0] = x[j];
+        }
+        return end == n ? 0 : -1;
+    }
+    // New upper divergence bound
+    for (int j = index; j < end; ++j) {
+        bounds[j][1] = x[j];
+    }
+    return end == n ? 0 : 1;
+}
+
+void KKTSolver::fast_l2_huber(const InputData &inputData, OutputData *result) {
+    assert(inputData._n >= 2 && inputData._p == 2);
+    assert(inputData._deviationType == InputData::LP &&
+           inputData._separationType == InputData::HUBER_S);
+    assert(result != NULL);
+
+    for (int i = 0; i < inputData._n; ++i) {
+        data_type l = result->_bounds[i][0];
+        data_type u = result->_bounds[i][1];
+        result->_x[i] = (l + u) / 2;
+        if (u - l < inputData._solEsp) {
+            continue;
+        }
+        data_type drvtValue;
+        int state = propagateL2Huber(inputData, result, i, &drvtValue);
+        while (u - l >= inputData._solEsp) {
+            if (state == 0 && fabs(drvtValue) < inputData._drvtEsp) {
+                // The propagation reached the end: x is the solution.
+                return;
+            }
+            if (state < 0 || (state == 0 && drvtValue < 0)) {
+                // Go up.
+                l = result->_x[i];
+            } else {
+                // Go down.
+                u = result->_x[i];
+            }
+            result->_x[i] = (l + u) / 2;
+            state = propagateL2Huber(inputData, result, i, &drvtValue);
+        }
+    }
+}
+
+// Derivative of the piecewise deviation starting at ${pw} with ${bkpNum} breakpoints.
+// If its piece is the same for all x in (l, u), accumulate it into
+// drvtCoeff * x + drvtConst and return true. Otherwise, add its value at x to
+// out_undDrvtValue, narrow [bkpL, bkpR) to the piece containing x, and return false.
+static inline bool settlePw(int pwDeg, const data_type* pw, int bkpNum,
+                            data_type x, data_type l, data_type u,
+                            data_type* drvtCoeff, data_type* drvtConst,
+                            data_type* out_undDrvtValue,
+                            data_type* bkpL, data_type* bkpR) {
+    int stride = pwDeg + 1;
+    int pwIndex = getPQIndex(pwDeg, pw, bkpNum, 0, x);
+    data_type lo = pwIndex == 0 ? -KKT_INFINITY : pw[pwDeg + stride * (pwIndex - 1)];
+    data_type hi = pwIndex == bkpNum ? KKT_INFINITY : pw[pwDeg + stride * pwIndex];
+    // Derivative of the piece: coeff * x + constant.
+    data_type coeff = 0, constant = pw[stride * pwIndex];
+    if (pwDeg == 2) {
+        coeff = constant;
+        constant = -pw[stride * pwIndex + 1];
+    }
+    if (lo <= l && hi >= u) {
+        *drvtCoeff += coeff;
+        *drvtConst += constant;
+        return true;
+    }
+    *out_undDrvtValue += coeff * x + constant;
+    if (lo > *bkpL) *bkpL = lo;
+    if (hi < *bkpR) *bkpR = hi;
+    return false;
+}
+
+// Shared implementation of fast_pwl1_l1 and fast_pwl2_l1.
+static void fastPwL1(const InputData &inputData, OutputData *result) {
+    int n = inputData._n;
+    int pwDeg = inputData._pwDeg;
+    // Prefix-summed offsets of each deviation function in _pw.
+    std::vector<int> pwOffset(n, 0);
+    for (int i = 0; i < n - 1; ++i) {
+        pwOffset[i + 1] = pwOffset[i] + (pwDeg + 1) * inputData._bkpNums[i] + pwDeg;
+    }
+
+    int i = 0;
+    // Nodes whose piece is not settled by the search interval.
+    std::vector<std::vector<int>> accuUndIndex(2);
+    std::vector<int> undIndex;
+    while (i < n) {
+        std::vector<int> boundIndex(2, i);
+        std::vector<data_type> accuDrvtCoeff(2, 0);
+        std::vector<data_type> accuDrvtConst(2, 0);
+        for (int b = 0; b < 2; ++b) {
+            accuUndIndex[b].clear();
+            accuUndIndex[b].push_back(i);
+        }
+        data_type l = result->_bounds[i][0];
+        data_type u = result->_bounds[i][1];
+        result->_x[i] = (l + u) / 2;
+        while (u - l >= inputData._solEsp) {
+            int binIndex = getStIndex(boundIndex);
+            int stIndex = boundIndex[binIndex];
+            data_type drvtCoeff = accuDrvtCoeff[binIndex];
+            data_type drvtConst = accuDrvtConst[binIndex];
+            data_type x = result->_x[i];
+            data_type undDrvtValue = 0;
+            // Piece of x among the unsettled breakpoints.
+            data_type bkpL = l, bkpR = u;
+            // Settle the nodes that the shrunk interval has determined.
+            undIndex.clear();
+            const std::vector<int>& prevUndIndex = accuUndIndex[binIndex];
+            for (int k = 0; k < prevUndIndex.size(); ++k) {
+                int j = prevUndIndex[k];
+                if (!settlePw(pwDeg, inputData._pw + pwOffset[j], inputData._bkpNums[j],
+                              x, l, u, &drvtCoeff, &drvtConst, &undDrvtValue,
+                              &bkpL, &bkpR)) {
+                    undIndex.push_back(j);
+                }
+            }
+            data_type l1Const = 0;
+            if (i > 0) {
+                // Include previous slope, with the right sub-derivative that
+                // getPQIndex takes at the breakpoints.
+                l1Const = l1DevDrvt(x, result->_x[i - 1], inputData._cSep[i - 1]);
+            }
+            data_type drvtValue = drvtCoeff * x + drvtConst + undDrvtValue + l1Const;
+            // +1: Go down; -1: Go up.
+            int direction = drvtValue >= 0 ? 1 : -1;
+            // Propagation
+            while (stIndex < n - 1) {
+                bool success = drvtValue >= 0 ?
+                    drvtValue < inputData._cSep[stIndex] :
+                    -drvtValue <= inputData._cSep[stIndex];
+                if (!success) {
+                    // Propagate failed, bound exceeded
+                    direction = drvtValue >= 0 ? 1 : -1;
+                    break;
+                }
+                // Propagate success
+                int j = stIndex + 1;
+                if (!settlePw(pwDeg, inputData._pw + pwOffset[j], inputData._bkpNums[j],
+                              x, l, u, &drvtCoeff, &drvtConst, &undDrvtValue,
+                              &bkpL, &bkpR)) {
+                    undIndex.push_back(j);
+                }
+                drvtValue = drvtCoeff * x + drvtConst + undDrvtValue + l1Const;
+                stIndex++;
+            }
+
+            if (stIndex == n - 1) {
+                // Reach the end, no early stopping.
+                direction = drvtValue >= 0 ? 1 : -1;
+            }
+            // Update the data structures
+            int dirIndex = direction == 1 ? 1 : 0;
+            boundIndex[dirIndex] = stIndex;
+            accuDrvtCoeff[dirIndex] = drvtCoeff;
+            accuDrvtConst[dirIndex] = drvtConst;
+            accuUndIndex[dirIndex].swap(undIndex);
+
+            // Find the next search value.
+            if (pwDeg == 1) {
+                // Piecewise constant derivatives: the probe outcome holds on
+                // the whole piece [bkpL, bkpR) around x.
+                if (i > 0) {
+                    data_type a = result->_x[i - 1];
+                    if (a <= x && a > bkpL) bkpL = a;
+                    if (a > x && a < bkpR) bkpR = a;
+                }
+                if (direction == -1) {
+                    l = bkpR;
+                } else {
+                    u = bkpL;
+                }
+            } else {
+                if (direction == -1) {
+                    l = x;
+                } else {
+                    u = x;
+                }
+            }
+            result->_x[i] = (l + u) / 2;
+        }
+        int binIndex = getStIndex(boundIndex);
+        int stIndex = boundIndex[binIndex];
+        for (int j = i + 1; j <= stIndex; ++j) {
+            result->_x[j] = result->_x[i];
+        }
+        i = stIndex + 1;
+    }
+}
+
+void KKTSolver::fast_pwl1_l1(const InputData &inputData, OutputData *result) {
+    assert(inputData._n >= 2 && inputData._q == 1);
+    assert(inputData._deviationType == InputData::PIECEWISE_LP && inputData._pwDeg == 1);
+    assert(result != NULL);
+    fastPwL1(inputData, result);
+}
+
+void KKTSolver::fast_pwl2_l1(const InputData &inputData, OutputData *result) {
+    assert(inputData._n >= 2 && inputData._q == 1);
+    assert(inputData._deviationType == InputData::PIECEWISE_LP && inputData._pwDeg == 2);
+    assert(result != NULL);
+    fastPwL1(inputData, result);
+}
+
+// LDL^T factorization of the diagonal block [first, last] of the l2-l2 system.
+// l[k] is the multiplier of row k (l[0] unused), invD[k] the inverse pivot.
+static void ldltFactor(const InputData& inputData, int first, int last,
+                       data_type* l, data_type* invD) {
+    data_type pivot = 0;
+    for (int i = first; i <= last; ++i) {
+        int k = i - first;
+        data_type diag = inputData._cDev[i];
+        if (i > 0) diag += inputData._cSep[i - 1];
+        if (i < inputData._n - 1) diag += inputData._cSep[i];
+        if (k == 0) {
+            l[k] = 0;
+            pivot = diag;
+        } else {
+            l[k] = -inputData._cSep[i - 1] * invD[k - 1];
+            pivot = diag + l[k] * inputData._cSep[i - 1];
+        }
+        assert(pivot > 0);
+        invD[k] = 1.0 / pivot;
+    }
+}
+
+// Solve L D L^T x = b in place.
+static void ldltSolve(int m, const data_type* l, const data_type* invD,
+                      data_type* b) {
+    for (int k = 1; k < m; ++k) {
+        b[k] -= l[k] * b[k - 1];
+    }
+    b[m - 1] *= invD[m - 1];
+    for (int k = m - 2; k >= 0; --k) {
+        b[k] = b[k] * invD[k] - l[k + 1] * b[k + 1];
+    }
+}
+
+void KKTSolver::factor_l2_l2(const InputData &inputData, L2L2Factor *factor) {
+    assert(inputData._n >= 1 && inputData._p == 2 && inputData._q == 2);
+    assert(inputData._deviationType == InputData::LP &&
+           inputData._separationType == InputData::LQ);
+    assert(factor != NULL);
+    int n = inputData._n;
+    factor->_n = n;
+    factor->_l.resize(n);
+    factor->_invD.resize(n);
+    factor->_cDev.assign(inputData._cDev, inputData._cDev + n);
+    ldltFactor(inputData, 0, n - 1, factor->_l.data(), factor->_invD.data());
+}
+
+void KKTSolver::solve_l2_l2(const L2L2Factor &factor, const data_type *aDev,
+                            OutputData *result) {
+    assert(aDev != NULL && result != NULL && result->_n == factor._n);
+    int n = factor._n;
+    for (int i = 0; i < n; ++i) {
+        result->_x[i] = factor._cDev[i] * aDev[i];
+    }
+    ldltSolve(n, factor._l.data(), factor._invD.data(), result->_x);
+}
+
+void KKTSolver::fast_l2_l2(const InputData &inputData, OutputData *result) {
+    L2L2Factor factor;
+    factor_l2_l2(inputData, &factor);
+    solve_l2_l2(factor, inputData._aDev, result);
+}
+
+// SPIKE step for block [first, last]: solve A_k y = b_k, and the spikes
+// A_k v = -c_{last,last+1} e_last and A_k w = -c_{first-1,first} e_first.
+static void l2l2Block(const InputData& inputData, int first, int last,
+                      data_type* y, data_type* v, data_type* w) {
+    int m = last - first + 1;
+    std::vector<data_type> l(m), invD(m);
+    ldltFactor(inputData, first, last, l.data(), invD.data());
+    for (int k = 0; k < m; ++k) {
+        y[k] = inputData._cDev[first + k] * inputData._aDev[first + k];
+        v[k] = 0;
+        w[k] = 0;
+    }
+    ldltSolve(m, l.data(), invD.data(), y);
+    if (last < inputData._n - 1) {
+        v[m - 1] = -inputData._cSep[last];
+        ldltSolve(m, l.data(), invD.data(), v);
+    }
+    if (first > 0) {
+        w[0] = -inputData._cSep[first - 1];
+        ldltSolve(m, l.data(), invD.data(), w);
+    }
+}
+
+void KKTSolver::fast_l2_l2_parallel(const InputData &inputData, OutputData *result,
+                                    int numThreads) {
+    assert(inputData._n >= 1 && inputData._p == 2 && inputData._q == 2);
+    assert(inputData._deviationType == InputData::LP &&
+           inputData._separationType == InputData::LQ);
+    assert(result != NULL && numThreads >= 1);
+    int n = inputData._n;
+    int P = std::min(numThreads, n / 2);
+    if (P <= 1) {
+        fast_l2_l2(inputData, result);
+        return;
+    }
+    std::vector<int> first(P + 1);
+    for (int k = 0; k <= P; ++k) {
+        first[k] = (int)((long long)n * k / P);
+    }
+    data_type* y = result->_x;
+    std::vector<data_type> v(n), w(n);
+
+    // Step 1: Independent block solves.
+    std::vector<std::thread> threads;
+    for (int k = 0; k < P; ++k) {
+        threads.push_back(std::thread(l2l2Block, std::cref(inputData),
+                                      first[k], first[k + 1] - 1,
+                                      y + first[k], v.data() + first[k],
+                                      w.data() + first[k]));
+    }
+    for (int k = 0; k < P; ++k) {
+        threads[k].join();
+    }
+
+    // Step 2: Reduced system on the block end points, ordered as
+    // (x_first(0), x_last(0), x_first(1), x_last(1), ...):
+    //   x_e(k) + v_e(k) x_first(k+1) + w_e(k) x_last(k-1) = y_e(k).
+    int m = 2 * P;
+    std::vector<data_type> A(m * m, 0), b(m, 0);
+    for (int k = 0; k < P; ++k) {
+        int ends[2] = {first[k], first[k + 1] - 1};
+        for (int e = 0; e < 2; ++e) {
+            int row = 2 * k + e;
+            A[row * m + row] += 1;
+            if (k < P - 1) A[row * m + 2 * (k + 1)] += v[ends[e]];
+            if (k > 0) A[row * m + 2 * (k - 1) + 1] += w[ends[e]];
+            b[row] = y[ends[e]];
+        }
+    }
+    // Gaussian elimination with partial pivoting.
+    for (int c = 0; c < m; ++c) {
+        int pivot = c;
+        for (int r = c + 1; r < m; ++r) {
+            if (fabs(A[r * m + c]) > fabs(A[pivot * m + c])) pivot = r;
+        }
+        if (pivot != c) {
+            for (int j = 0; j < m; ++j) std::swap(A[c * m + j], A[pivot * m + j]);
+            std::swap(b[c], b[pivot]);
+        }
+        for (int r = c + 1; r < m; ++r) {
+            data_type factor = A[r * m + c] / A[c * m + c];
+            if (factor == 0) continue;
+            for (int j = c; j < m; ++j) A[r * m + j] -= factor * A[c * m + j];
+            b[r] -= factor * b[c];
+        }
+    }
+    std::vector<data_type> ends(m);
+    for (int r = m - 1; r >= 0; --r) {
+        data_type sum = b[r];
+        for (int j = r + 1; j < m; ++j) sum -= A[r * m + j] * ends[j];
+        ends[r] = sum / A[r * m + r];
+    }
+
+    // Step 3: Finalize blocks: x = y - v x_first(k+1) - w x_last(k-1).
+    threads.clear();
+    for (int k = 0; k < P; ++k) {
+        data_type right = k < P - 1 ? ends[2 * (k + 1)] : 0;
+        data_type left = k > 0 ? ends[2 * (k - 1) + 1] : 0;
+        threads.push_back(std::thread([=, &v, &w]() {
+            for (int i = first[k]; i < first[k + 1]; ++i) {
+                y[i] -= v[i] * right + w[i] * left;
+            }
+        }));
+    }
+    for (int k = 0; k < P; ++k) {
+        threads[k].join();
+    }
+}
+
+void KKTSolver::fast_linear_l2(const InputData &inputData, OutputData *result) {
+    assert(inputData._n >= 2 && inputData._p == 1 && inputData._q == 2);
+    assert(result != NULL);
+    data_type linCoeffSum = 0;
+    int n = inputData._n;
+    for (int i = 0; i < n; ++i) {
+        linCoeffSum += inputData._cDev[i];
+    }
+    assert(fabs(linCoeffSum) < 1e-6);
+
+    fast_linear_l2(inputData, result, 0, 0);
+}
+
+void KKTSolver::fast_linear_l2(KKTWorkspace* workspace) {
+    assert(workspace != NULL);
+    workspace->restart();
+    fast_linear_l2(workspace->input(), &workspace->output());
+}
+
+// Per-block partial sums of the first pass of the blocked linear_l2 scan,
+// over edges [first, last). With S_i the prefix sum of c within the block:
+//   sumC = S_{last-1}, sumInc = \sum S_i / w_i, sumInvW = \sum 1 / w_i,
+// and the same restricted to edges after (Ge) and before (Lt) the anchor.
+struct LinearL2Block {
+    data_type sumC = 0;
+    data_type sumInc = 0, sumInvW = 0;
+    data_type sumInvWGe = 0;
+    data_type sumIncLt = 0, sumInvWLt = 0;
+};
+
+static void linearL2BlockSums(const InputData& inputData, int first, int last,
+                              int anchorIndex, LinearL2Block* block) {
+    data_type sumC = 0, sumInc = 0, sumInvW = 0;
+    data_type sumInvWGe = 0, sumIncLt = 0, sumInvWLt = 0;
+    for (int i = first; i < last; ++i) {
+        sumC += inputData._cDev[i];
+        // Both passes divide by the edge weights.
+        assert(inputData._cSep[i] > 0);
+        data_type invW = 1.0 / inputData._cSep[i];
+        sumInc += sumC * invW;
+        sumInvW += invW;
+        if (i >= anchorIndex) {
+            sumInvWGe += invW;
+        } else {
+            sumIncLt += sumC * invW;
+            sumInvWLt += invW;
+        }
+    }
+    block->sumC = sumC;
+    block->sumInc = sumInc;
+    block->sumInvW = sumInvW;
+    block->sumInvWGe = sumInvWGe;
+    block->sumIncLt = sumIncLt;
+    block->sumInvWLt = sumInvWLt;
+}
+
+// Second pass: x_{i+1} = x_i + (S_i - [i >= anchor] * total) / w_i over edges [first, last).
+static void linearL2BlockScan(const InputData& inputData, int first, int last,
+                              int anchorIndex, data_type cOffset,
+                              data_type total, data_type xStart, data_type* x) {
+    data_type sumC = cOffset;
+    data_type xValue = xStart;
+    for (int i = first; i < last; ++i) {
+        sumC += inputData._cDev[i];
+        data_type grad = i >= anchorIndex ? sumC - total : sumC;
+        xValue += grad / inputData._cSep[i];
+        x[i + 1] = xValue;
+    }
+}
+
+void KKTSolver::fast_linear_l2(const InputData &inputData, OutputData *result,
+                               int anchorIndex, data_type anchorValue,
+                               int numThreads) {
+    assert(inputData._n >= 2 && inputData._p == 1 && inputData._q == 2);
+    assert(anchorIndex >= 0 && anchorIndex < inputData._n);
+    assert(result != NULL && numThreads >= 1);
+    int n = inputData._n;
+    int numEdges = n - 1;
+    // Small blocks are not worth a thread.
+    const int minBlockSize = 1 << 16;
+    int P = std::max(1, std::min(numThreads, numEdges / minBlockSize));
+    std::vector<int> first(P + 1);
+    for (int k = 0; k <= P; ++k) {
+        first[k] = (int)((long long)numEdges * k / P);
+    }
+
+    // Pass 1: block sums.
+    std::vector<LinearL2Block> blocks(P);
+    std::vector<std::thread> threads;
+    for (int k = 1; k < P; ++k) {
+        threads.push_back(std::thread(linearL2BlockSums, std::cref(inputData),
+                                      first[k], first[k + 1], anchorIndex,
+                                      &blocks[k]));
+    }
+    linearL2BlockSums(inputData, first[0], first[1], anchorIndex, &blocks[0]);
+    for (int k = 0; k < threads.size(); ++k) {
+        threads[k].join();
+    }
+
+    // Serial combine: offsets of c and of x at each block start.
+    data_type total = inputData._cDev[n - 1];
+    for (int k = 0; k < P; ++k) {
+        total += blocks[k].sumC;
+    }
+    std::vector<data_type> cOffset(P + 1, 0), xOffset(P + 1, 0);
+    data_type anchorRaw = 0;
+    for (int k = 0; k < P; ++k) {
+        const LinearL2Block& block = blocks[k];
+        if (anchorIndex >= first[k] && anchorIndex < first[k + 1]) {
+            anchorRaw = xOffset[k] + block.sumIncLt + cOffset[k] * block.sumInvWLt;
+        }
+        cOffset[k + 1] = cOffset[k] + block.sumC;
+        xOffset[k + 1] = xOffset[k] + block.sumInc + cOffset[k] * block.sumInvW
+            - total * block.sumInvWGe;
+    }
+    if (anchorIndex == n - 1) {
+        anchorRaw = xOffset[P];
+    }
+    data_type shift = anchorValue - anchorRaw;
+
+    // Pass 2: block scans.
+    result->_x[0] = shift;
+    threads.clear();
+    for (int k = 1; k < P; ++k) {
+        threads.push_back(std::thread(linearL2BlockScan, std::cref(inputData),
+                                      first[k], first[k + 1], anchorIndex,
+                                      cOffset[k], total, xOffset[k] + shift,
+                                      result->_x));
+    }
+    linearL2BlockScan(inputData, first[0], first[1], anchorIndex, cOffset[0],
+                      total, shift, result->_x);
+    for (int k = 0; k < threads.size(); ++k) {
+        threads[k].join();
+    }
+}
+
+// Fill the unobserved nodes strictly between observed nodes ${left} and ${right},
+// given x[left] and x[right]. The total difference x[left] - x[right] is split
+// among the edges such that all edges share the same separation derivative.
+static void fillGap(const InputData& inputData, int left, int right,
+                    data_type* x) {
+    assert(left >= 0 && right < inputData._n && left < right);
+    if (right - left == 1) return;
+    data_type diff = x[left] - x[right];
+    int q = inputData._q;
+    int minIndex = left;
+    for (int k = left; k < right; ++k) {
+        if (inputData._cSep[k] < inputData._cSep[minIndex]) {
+            minIndex = k;
+        }
+    }
+    if (q == 1 || inputData._cSep[minIndex] <= 0) {
+        // The whole jump is taken by the cheapest (or a free) edge.
+        for (int k = left + 1; k <= minIndex; ++k) {
+            x[k] = x[left];
+        }
+        for (int k = minIndex + 1; k < right; ++k) {
+            x[k] = x[right];
+        }
+        return;
+    }
+    // q > 1: Edge k takes a share proportional to c_k^{-1/(q-1)}.
+    data_type wSum = 0;
+    for (int k = left; k < right; ++k) {
+        wSum += Pow(inputData._cSep[k], -1.0 / (q - 1));
+    }
+    for (int k = left; k < right - 1; ++k) {
+        x[k + 1] = x[k] - diff * Pow(inputData._cSep[k], -1.0 / (q - 1)) / wSum;
+    }
+}
+
+void KKTSolver::solveSparse(const InputData& inputData, OutputData* result) {
+    assert(inputData._n >= 1 && inputData._p >= 1 && inputData._q >= 1);
+    assert(inputData._deviationType == InputData::LP ||
+           inputData._deviationType == InputData::HUBER_D);
+    assert(inputData._separationType == InputData::LQ);
+    assert(result != NULL);
+
+    int n = inputData._n;
+    int q = inputData._q;
+    std::vector<int> obsIndex;
+    for (int i = 0; i < n; ++i) {
+        if (inputData._cDev[i] != 0) {
+            obsIndex.push_back(i);
+        }
+    }
+    int m = (int)obsIndex.size();
+    if (m == 0) {
+        // Any constant solution is optimal.
+        for (int i = 0; i < n; ++i) {
+            result->_x[i] = (result->_bounds[i][0] + result->_bounds[i][1]) / 2;
+        }
+        return;
+    }
+
+    // Build the compressed problem on the observed nodes.
+    InputData subData(m, inputData._p, q, inputData._deviationType, InputData::LQ);
+    subData._p = inputData._p;
+    subData._lb = inputData._lb;
+    subData._ub = inputData._ub;
+    subData._solEsp = inputData._solEsp;
+    subData._drvtEsp = inputData._drvtEsp;
+    subData._infinity = inputData._infinity;
+    for (int j = 0; j < m; ++j) {
+        subData._cDev[j] = inputData._cDev[obsIndex[j]];
+        subData._aDev[j] = inputData._aDev[obsIndex[j]];
+        if (subData._huberD != NULL) {
+            subData._huberD[j] = inputData._huberD[obsIndex[j]];
+        }
+    }
+    for (int j = 0; j < m - 1; ++j) {
+        // Composed separation coefficient of edges [obsIndex[j], obsIndex[j + 1]).
+        data_type cSep = 0;
+        if (q == 1) {
+            cSep = inputData._cSep[obsIndex[j]];
+            for (int k = obsIndex[j] + 1; k < obsIndex[j + 1]; ++k) {
+                if (inputData._cSep[k] < cSep) cSep = inputData._cSep[k];
+            }
+        } else {
+            data_type wSum = 0;
+            bool isFree = false;
+            for (int k = obsIndex[j]; k < obsIndex[j + 1]; ++k) {
+                if (inputData._cSep[k] <= 0) {
+                    isFree = true;
+                    break;
+                }
+                wSum += Pow(inputData._cSep[k], -1.0 / (q - 1));
+            }
+            cSep = isFree ? 0 : Pow(wSum, -(q - 1.0));
+        }
+        subData._cSep[j] = cSep;
+    }
+
+    OutputData subResult(subData);
+    if (subData._deviationType == InputData::LP && subData._p == 2 &&
+        q == 1 && m >= 2) {
+        fast_l2_l1(subData, &subResult);
+    } else {
+        solve(subData, &subResult);
+    }
+
+    // Scatter back and fill the gaps.
+    for (int j = 0; j < m; ++j) {
+        result->_x[obsIndex[j]] = subResult._x[j];
+    }
+    for (int i = 0; i < obsIndex[0]; ++i) {
+        result->_x[i] = subResult._x[0];
+    }
+    for (int i = obsIndex[m - 1] + 1; i < n; ++i) {
+        result->_x[i] = subResult._x[m - 1];
+    }
+    for (int j = 0; j < m - 1; ++j) {
+        fillGap(inputData, obsIndex[j], obsIndex[j + 1], result->_x);
+    }
+}
+
+// Derivative of the separation function of edge (i, i + 1) at
+// d = x_{i+1} - x_i, for LQ and HUBER_S.
+static inline data_type sepDrvt(const InputData& inputData, int i, data_type d) {
+    data_type c = inputData._cSep[i];
+    if (inputData._separationType == InputData::HUBER_S) {
+        return c * huberDrvt(d, inputData._huberS[i]);
+    }
+    data_type drvt = c * Pow(fabs(d), inputData._q - 1);
+    return d < 0 ? -drvt : drvt;
+}
+
+// Copies the parameters of the subData->_n nodes of ${inputData} from node
+// ${first}, and the edges between them, into ${subData} (of the same types,
+// LP / HUBER_D deviations).
+static void copyChain(const InputData& inputData, int first, InputData* subData) {
+    int m = subData->_n;
+    assert(first >= 0 && first + m <= inputData._n);
+    subData->_p = inputData._p;
+    subData->_lb = inputData._lb;
+    subData->_ub = inputData._ub;
+    subData->_solEsp = inputData._solEsp;
+    subData->_drvtEsp = inputData._drvtEsp;
+    subData->_infinity = inputData._infinity;
+    std::copy(inputData._cDev + first, inputData._cDev + first + m, subData->_cDev);
+    std::copy(inputData._aDev + first, inputData._aDev + first + m, subData->_aDev);
+    std::copy(inputData._cSep + first, inputData._cSep + first + m - 1, subData->_cSep);
+    if (subData->_huberD != NULL) {
+        std::copy(inputData._huberD + first, inputData._huberD + first + m,
+                  subData->_huberD);
+    }
+    if (subData->_huberS != NULL) {
+        std::copy(inputData._huberS + first, inputData._huberS + first + m - 1,
+                  subData->_huberS);
+    }
+}
+
+// Runs fn(begin, end) on ${numThreads} contiguous blocks of [0, count).
+template <typename Fn>
+static void parallelBlocks(int numThreads, long long count, Fn fn) {
+    if (numThreads <= 1 || count < numThreads) {
+        fn(0LL, count);
+        return;
+    }
+    std::vector<std::thread> threads;
+    long long blockSize = (count + numThreads - 1) / numThreads;
+    for (long long begin = 0; begin < count; begin += blockSize) {
+        threads.push_back(std::thread(fn, begin, std::min(begin + blockSize, count)));
+    }
+    for (int t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+}
+
+// Node range [_first, _last] re-solved by resolve().
+struct ResolveWindow {
+    int _first, _last;
+    bool _done;
+};
+
+int KKTSolver::resolve(const InputData& inputData, OutputData* result,
+                       const std::vector<int>& editedNodes,
+                       const std::vector<int>& editedSeps) {
+    assert(result != NULL);
+    std::map<int, data_type> oldX;
+    return resolveRange(inputData, result->_x, 0, inputData._n, editedNodes,
+                        editedSeps, &oldX);
+}
+
+int KKTSolver::resolveRange(const InputData& inputData, data_type* x, int begin,
+                            int end, const std::vector<int>& editedNodes,
+                            const std::vector<int>& editedSeps,
+                            std::map<int, data_type>* oldX, int numThreads) {
+    assert(inputData._n >= 1 && inputData._p >= 1 && inputData._q >= 1);
+    assert(inputData._deviationType == InputData::LP ||
+           inputData._deviationType == InputData::HUBER_D);
+    assert(inputData._separationType == InputData::LQ ||
+           inputData._separationType == InputData::HUBER_S);
+    assert(!inputData._isotonic && inputData._parent == NULL);
+    assert(x != NULL && oldX != NULL && numThreads >= 1);
+    assert(begin >= 0 && begin < end && end <= inputData._n);
+
+    data_type eps = inputData._solEsp;
+    data_type tol = inputData._drvtEsp;
+    auto old = [&](int i) {
+        auto it = oldX->find(i);
+        return it == oldX->end() ? x[i] : it->second;
+    };
+    // Ends of the fused segment of the old solution containing node i.
+    auto segFirst = [&](int i) {
+        while (i > begin && fabs(old(i) - old(i - 1)) < eps) --i;
+        return i;
+    };
+    auto segLast = [&](int i) {
+        while (i < end - 1 && fabs(old(i + 1) - old(i)) < eps) ++i;
+        return i;
+    };
+
+    std::vector<ResolveWindow> windows;
+    auto addWindow = [&](int first, int last) {
+        first = segFirst(first);
+        if (first > begin) first = segFirst(first - 1);
+        last = segLast(last);
+        if (last < end - 1) last = segLast(last + 1);
+        windows.push_back({first, last, false});
+    };
+    for (int i : editedNodes) {
+        assert(i >= begin && i < end);
+        addWindow(i, i);
+    }
+    for (int i : editedSeps) {
+        assert(i >= begin && i < end - 1);
+        addWindow(i, i + 1);
+    }
+
+    // Solves window w with x pinned at its outer neighbors, and accepts it if
+    // the multipliers chain from the old left break to the old right break;
+    // the new x[first, last] is then returned in ${out}. Reads x only at the
+    // window and its neighbors, so separated windows solve concurrently.
+    auto solveWindow = [&](const ResolveWindow& w, std::vector<data_type>* out) {
+        int first = w._first, last = w._last;
+        bool hasLeft = first > begin, hasRight = last < end - 1;
+        int offset = hasLeft ? 1 : 0;
+        int m = last - first + 1 + offset + (hasRight ? 1 : 0);
+        InputData subData(m, inputData._p, inputData._q,
+                          inputData._deviationType, inputData._separationType);
+        copyChain(inputData, first - offset, &subData);
+        OutputData subResult(subData);
+        if (hasLeft) {
+            subResult._bounds[0][0] = subResult._bounds[0][1] = x[first - 1];
+        }
+        if (hasRight) {
+            subResult._bounds[m - 1][0] = subResult._bounds[m - 1][1] = x[last + 1];
+        }
+        solve(subData, &subResult);
+        const data_type* y = subResult._x + offset - first;  // y[i], first <= i <= last.
+
+        bool accept = !hasLeft && !hasRight;
+        if (!accept) {
+            // Interval of the multiplier F_i, intersected with the subgradients
+            // of h_i within eps of the new x_{i+1} - x_i.
+            data_type lo = 0, hi = 0;
+            auto clampSep = [&](int i, data_type d) {
+                lo = std::max(lo, sepDrvt(inputData, i, d - eps));
+                hi = std::min(hi, sepDrvt(inputData, i, d + eps));
+                if (lo > hi + tol) return false;
+                if (lo > hi) lo = hi = (lo + hi) / 2;
+                return true;
+            };
+            accept = true;
+            if (hasLeft) {
+                lo = hi = sepDrvt(inputData, first - 1, old(first) - x[first - 1]);
+                accept = clampSep(first - 1, y[first] - x[first - 1]);
+            }
+            for (int i = first; accept && i <= last; ++i) {
+                lo += devDrvt(inputData, i, y[i] - eps);
+                hi += devDrvt(inputData, i, y[i] + eps);
+                if (i < end - 1) {
+                    accept = clampSep(i, (i < last ? y[i + 1] : x[i + 1]) - y[i]);
+                }
+            }
+            data_type target = hasRight ? sepDrvt(inputData, last, x[last + 1] - old(last)) : 0;
+            accept = accept && target >= lo - tol && target <= hi + tol;
+        }
+        if (accept) {
+            out->assign(y + first, y + last + 1);
+        }
+        return accept;
+    };
+
+    int numSolved = 0;
+    bool pending = !windows.empty();
+    while (pending) {
+        // Merge overlapping and adjacent windows: a pinned neighbor must stay
+        // at its old value.
+        std::sort(windows.begin(), windows.end(),
+                  [](const ResolveWindow& a, const ResolveWindow& b) {
+                      return a._first < b._first;
+                  });
+        int k = 0;
+        for (int j = 1; j < windows.size(); ++j) {
+            if (windows[j]._first <= windows[k]._last + 1) {
+                windows[k]._last = std::max(windows[k]._last, windows[j]._last);
+                windows[k]._done = windows[k]._done && windows[j]._done;
+            } else {
+                windows[++k] = windows[j];
+            }
+        }
+        windows.resize(k + 1);
+
+        // The merged windows are at least one node apart.
+        std::vector<int> open;
+        for (int k = 0; k < windows.size(); ++k) {
+            if (!windows[k]._done) open.push_back(k);
+        }
+        std::vector<std::vector<data_type>> ys(open.size());
+        std::vector<char> accepted(open.size());
+        parallelBlocks(numThreads, (long long)open.size(),
+                       [&](long long first, long long last) {
+            for (long long k = first; k < last; ++k) {
+                accepted[k] = solveWindow(windows[open[k]], &ys[k]);
+            }
+        });
+
+        pending = false;
+        for (int k = 0; k < open.size(); ++k) {
+            ResolveWindow& w = windows[open[k]];
+            numSolved += w._last - w._first + 1;
+            if (accepted[k]) {
+                for (int i = w._first; i <= w._last; ++i) {
+                    oldX->insert(std::make_pair(i, x[i]));
+                    x[i] = ys[k][i - w._first];
+                }
+                w._done = true;
+            } else {
+                int len = w._last - w._first + 1;
+                w._first = segFirst(std::max(w._first - len, begin));
+                w._last = segLast(std::min(w._last + len, end - 1));
+                pending = true;
+            }
+        }
+    }
+    return numSolved;
+}
+
+KKTSlidingWindow::KKTSlidingWindow(int capacity, InputData::deviation_type deviationType,
+                                   data_type lb, data_type ub)
+    : _capacity(capacity), _period(capacity + 1),
+      _data(2 * (capacity + 1), 2, 1, deviationType, InputData::LQ),
+      _x(2 * (capacity + 1), 0) {
+    assert(capacity >= 1);
+    assert(deviationType == InputData::LP || deviationType == InputData::HUBER_D);
+    assert(lb <= ub);
+    _data._lb = lb;
+    _data._ub = ub;
+}
+
+void KKTSlidingWindow::setNode(int i, data_type aDev, data_type cDev, data_type huberD) {
+    for (int j = i % _period; j < _data._n; j += _period) {
+        _data._aDev[j] = aDev;
+        _data._cDev[j] = cDev;
+        if (_data._huberD != NULL) {
+            _data._huberD[j] = huberD;
+        }
+    }
+}
+
+void KKTSlidingWindow::setSep(int i, data_type cSep) {
+    for (int j = i % _period; j < _data._n - 1; j += _period) {
+        _data._cSep[j] = cSep;
+    }
+}
+
+void KKTSlidingWindow::setX(int i, data_type x) {
+    for (int j = i % _period; j < _data._n; j += _period) {
+        _x[j] = x;
+    }
+}
+
+void KKTSlidingWindow::copyWindow(InputData* inputData) const {
+    assert(inputData != NULL && inputData->_n == _size && _size >= 1);
+    assert(inputData->_deviationType == _data._deviationType);
+    std::copy(_data._aDev + _head, _data._aDev + _head + _size, inputData->_aDev);
+    std::copy(_data._cDev + _head, _data._cDev + _head + _size, inputData->_cDev);
+    std::copy(_data._cSep + _head, _data._cSep + _head + _size - 1, inputData->_cSep);
+    if (_data._huberD != NULL) {
+        std::copy(_data._huberD + _head, _data._huberD + _head + _size,
+                  inputData->_huberD);
+    }
+    inputData->_lb = _data._lb;
+    inputData->_ub = _data._ub;
+}
+
+void KKTSlidingWindow::assign(const InputData& inputData) {
+    assert(inputData._deviationType == _data._deviationType);
+    assert(inputData._separationType == InputData::LQ && inputData._q == 1);
+    int m = std::min(inputData._n, _capacity);
+    int offset = inputData._n - m;
+    for (int i = 0; i < m; ++i) {
+        setNode(i, inputData._aDev[offset + i], inputData._cDev[offset + i],
+                inputData._huberD != NULL ? inputData._huberD[offset + i] : 1);
+        if (i < m - 1) {
+            setSep(i, inputData._cSep[offset + i]);
+        }
+    }
+    _head = 0;
+    _size = m;
+    InputData window(m, 2, 1, _data._deviationType, InputData::LQ);
+    copyWindow(&window);
+    OutputData result(window);
+    _solver.solveAuto(window, &result);
+    for (int i = 0; i < m; ++i) {
+        setX(i, result._x[i]);
+    }
+    _lastResolved = m;
+}
+
+void KKTSlidingWindow::push(data_type aDev, data_type cDev, data_type cSep,
+                            data_type huberD) {
+    // Physical slot of the new sample; the chain [_head, last] is contiguous.
+    int last = _head + _size;
+    setNode(last, aDev, cDev, huberD);
+    std::vector<int> editedNodes(1, last), editedSeps;
+    if (_size > 0) {
+        setSep(last - 1, cSep);
+        editedSeps.push_back(last - 1);
+        setX(last, _x[last - 1]);
+    } else {
+        setX(last, std::min(std::max(aDev, _data._lb), _data._ub));
+    }
+    bool full = _size == _capacity;
+    if (full) {
+        // Detach the oldest sample.
+        _data._cDev[_head] = 0;
+        _data._cSep[_head] = 0;
+        editedNodes.push_back(_head);
+        editedSeps.push_back(_head);
+    }
+    std::map<int, data_type> oldX;
+    _lastResolved = _solver.resolveRange(_data, _x.data(), _head, last + 1,
+                                         editedNodes, editedSeps, &oldX);
+    for (auto it = oldX.begin(); it != oldX.end(); ++it) {
+        setX(it->first, _x[it->first]);
+    }
+    if (full) {
+        _head = (_head + 1) % _period;
+    } else {
+        ++_size;
+    }
+}
+
+void KKTSolver::solveLines(const std::vector<int>& dims, int axis, const data_type* a,
+                           data_type* x, int p, int q, data_type c, data_type lambda,
+                           int numThreads) {
+    assert(axis >= 0 && axis < dims.size());
+    assert(p >= 1 && q >= 1 && c > 0 && lambda >= 0 && numThreads >= 1);
+    int len = dims[axis];
+    long long outer = 1, stride = 1;
+    for (int d = 0; d < axis; ++d) {
+        outer *= dims[d];
+    }
+    for (int d = axis + 1; d < dims.size(); ++d) {
+        stride *= dims[d];
+    }
+    if (len < 2) {
+        if (x != a) {
+            std::copy(a, a + outer * stride, x);
+        }
+        return;
+    }
+    // A work item is a tile of up to TV_TILE_WIDTH adjacent lines: element j of
+    // line (o, i) is at (o * len + j) * stride + i, so each j reads a contiguous run.
+    long long tilesPerOuter = (stride + TV_TILE_WIDTH - 1) / TV_TILE_WIDTH;
+    long long numTiles = outer * tilesPerOuter;
+    std::atomic<long long> nextTile(0);
+    auto worker = [&]() {
+        InputData lineData(len, p, q);
+        for (int j = 0; j < len; ++j) {
+            lineData._cDev[j] = c;
+        }
+        for (int j = 0; j < len - 1; ++j) {
+            lineData._cSep[j] = lambda;
+        }
+        OutputData lineResult(lineData);
+        std::vector<data_type> tile(TV_TILE_WIDTH * len);
+        for (long long t = nextTile++; t < numTiles; t = nextTile++) {
+            long long o = t / tilesPerOuter;
+            long long i0 = (t % tilesPerOuter) * TV_TILE_WIDTH;
+            int width = (int)std::min((long long)TV_TILE_WIDTH, stride - i0);
+            const data_type* src = a + o * len * stride + i0;
+            for (int j = 0; j < len; ++j) {
+                for (int b = 0; b < width; ++b) {
+                    tile[b * len + j] = src[j * stride + b];
+                }
+            }
+            for (int b = 0; b < width; ++b) {
+                // _aDev is a view of the line in the tile, then x replaces it.
+                lineData.borrow(InputData::ARRAY_ADEV, tile.data() + b * len);
+                lineResult.reset(lineData);
+                if (p == 2 && q == 1) {
+                    fast_l2_l1(lineData, &lineResult);
+                } else {
+                    solve(lineData, &lineResult);
+                }
+                std::copy(lineResult._x, lineResult._x + len, tile.begin() + b * len);
+            }
+            data_type* dst = x + o * len * stride + i0;
+            for (int j = 0; j < len; ++j) {
+                for (int b = 0; b < width; ++b) {
+                    dst[j * stride + b] = tile[b * len + j];
+                }
+            }
+        }
+    };
+    if (numThreads == 1) {
+        worker();
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.push_back(std::thread(worker));
+    }
+    for (int t = 0; t < numThreads; ++t) {
+        threads[t].join();
+    }
+}
+
+void KKTSolver::tv_prox(const std::vector<int>& dims, const data_type* y, data_type c,
+                        const std::vector<data_type>& lambdas, data_type* x, int iters,
+                        int numThreads) {
+    assert(!dims.empty() && lambdas.size() == dims.size());
+    assert(c > 0 && iters >= 1 && numThreads >= 1);
+    long long size = 1;
+    for (int d = 0; d < dims.size(); ++d) {
+        size *= dims[d];
+    }
+    std::vector<int> axes;
+    for (int d = 0; d < dims.size(); ++d) {
+        if (lambdas[d] > 0 && dims[d] > 1) {
+            axes.push_back(d);
+        }
+    }
+    if (axes.empty()) {
+        std::copy(y, y + size, x);
+        return;
+    }
+    // With weights w = 1/K over the K axis terms f_d = lambdas[d] TV_d:
+    //   p_d = prox_{f_d / w}(z_d);  x = \sum_d w p_d;  z_d += x - p_d.
+    // \sum_d w z_d stays y, and at the fixed point y - x \in \sum_d \partial f_d(x) / c.
+    int numAxes = (int)axes.size();
+    data_type w = 1.0 / numAxes;
+    std::vector<std::vector<data_type>> z(numAxes, std::vector<data_type>(y, y + size));
+    std::vector<data_type> prox(size);
+    for (int iter = 0; iter < iters; ++iter) {
+        std::fill(x, x + size, 0);
+        for (int k = 0; k < numAxes; ++k) {
+            solveLines(dims, axes[k], z[k].data(), prox.data(), 2, 1, c,
+                       numAxes * lambdas[axes[k]], numThreads);
+            data_type* zk = z[k].data();
+            parallelBlocks(numThreads, size, [&](long long begin, long long end) {
+                for (long long i = begin; i < end; ++i) {
+                    x[i] += w * prox[i];
+                    zk[i] -= prox[i];
+                }
+            });
+        }
+        if (iter + 1 < iters) {
+            for (int k = 0; k < numAxes; ++k) {
+                data_type* zk = z[k].data();
+                parallelBlocks(numThreads, size, [&](long long begin, long long end) {
+                    for (long long i = begin; i < end; ++i) {
+                        zk[i] += x[i];
+                    }
+                });
+            }
+        }
+    }
+}
+
+void KKTSolver::solveParallel(const InputData& inputData, OutputData* result,
+                              int numThreads) {
+    assert(inputData._n >= 1 && result != NULL && numThreads >= 1);
+    assert(inputData._deviationType == InputData::LP ||
+           inputData._deviationType == InputData::HUBER_D);
+    assert(inputData._separationType == InputData::LQ ||
+           inputData._separationType == InputData::HUBER_S);
+    int n = inputData._n;
+    int numBlocks = std::min(numThreads, n);
+    if (numBlocks <= 1) {
+        solveAuto(inputData, result, numThreads);
+        return;
+    }
+    int blockSize = (n + numBlocks - 1) / numBlocks;
+    // Cut edges (first - 1, first) of the blocks but the first one.
+    std::vector<int> cuts;
+    for (int first = blockSize; first < n; first += blockSize) {
+        cuts.push_back(first - 1);
+    }
+    // Solve the blocks decoupled at the cuts, each by a single-threaded
+    // solveAuto(): the blocks already take all the threads.
+    auto solveBlock = [&](int begin, int end) {
+        InputData blockData(end - begin, inputData._p, inputData._q,
+                            inputData._deviationType, inputData._separationType);
+        copyChain(inputData, begin, &blockData);
+        OutputData blockResult(blockData);
+        solveAuto(blockData, &blockResult, 1);
+        std::copy(blockResult._x, blockResult._x + blockData._n, result->_x + begin);
+    };
+    std::vector<std::thread> threads;
+    for (int first = 0; first < n; first += blockSize) {
+        threads.push_back(std::thread(solveBlock, first, std::min(first + blockSize, n)));
+    }
+    for (int t = 0; t < threads.size(); ++t) {
+        threads[t].join();
+    }
+    // The concatenation is optimal with the cut edges at 0. Restoring them is
+    // a local edit at each cut, re-solved around the cut with verified edges;
+    // the windows of the cuts are solved concurrently.
+    std::map<int, data_type> oldX;
+    resolveRange(inputData, result->_x, 0, n, std::vector<int>(), cuts, &oldX,
+                 numThreads);
+}
+
+void KKTSolver::solveMeet(const InputData& inputData, OutputData* result,
+                          std::atomic<int>* done, const std::atomic<int>& otherDone,
+                          const data_type* otherX) {
+    int n = inputData._n;
+    int pinned = 0;
+    for (int i = 0; i < n; ++i) {
+        int otherCount = otherDone.load(std::memory_order_acquire);
+        if (i >= n - otherCount) {
+            // Met the other direction.
+            return;
+        }
+        for (; pinned < otherCount; ++pinned) {
+            data_type x = otherX[pinned];
+            result->_bounds[n - 1 - pinned][0] = x;
+            result->_bounds[n - 1 - pinned][1] = x;
+        }
+        if (solveNode(inputData, result, i, NULL, NULL)) {
+            done->store(n, std::memory_order_release);
+            return;
+        }
+        done->store(i + 1, std::memory_order_release);
+    }
+}
+
+void KKTSolver::solveBidirectional(const InputData& inputData, OutputData* result) {
+    assert(inputData._n >= 1 && inputData._p >= 1 && inputData._q >= 1);
+    assert(inputData._deviationType == InputData::LP ||
+           inputData._deviationType == InputData::HUBER_D);
+    assert(inputData._separationType == InputData::LQ ||
+           inputData._separationType == InputData::HUBER_S);
+    assert(!inputData._isotonic && inputData._parent == NULL);
+    assert(result != NULL);
+    int n = inputData._n;
+    // Node i of the reversed chain is node n - 1 - i.
+    InputData reversedData(n, inputData._p, inputData._q,
+                           inputData._deviationType, inputData._separationType);
+    copyChain(inputData, 0, &reversedData);
+    std::reverse(reversedData._cDev, reversedData._cDev + n);
+    std::reverse(reversedData._aDev, reversedData._aDev + n);
+    std::reverse(reversedData._cSep, reversedData._cSep + n - 1);
+    if (reversedData._huberD != NULL) {
+        std::reverse(reversedData._huberD, reversedData._huberD + n);
+    }
+    if (reversedData._huberS != NULL) {
+        std::reverse(reversedData._huberS, reversedData._huberS + n - 1);
+    }
+    OutputData reversedResult(reversedData);
+    for (int i = 0; i < n; ++i) {
+        reversedResult._bounds[i][0] = result->_bounds[n - 1 - i][0];
+        reversedResult._bounds[i][1] = result->_bounds[n - 1 - i][1];
+    }
+
+    std::atomic<int> forwardDone(0), backwardDone(0);
+    std::thread backward([&]() {
+        solveMeet(reversedData, &reversedResult, &backwardDone, forwardDone, result->_x);
+    });
+    solveMeet(inputData, result, &forwardDone, backwardDone, reversedResult._x);
+    backward.join();
+    // Nodes the forward direction did not fix.
+    for (int i = forwardDone.load(); i < n; ++i) {
+        result->_x[i] = reversedResult._x[n - 1 - i];
+    }
+}
+
+
+// Per-worker task deque of solveBatch.
+struct BatchQueue {
+    std::mutex _mutex;
+    std::deque<int> _tasks;
+};
+
+// Next task of worker ${t}: the front of its own deque, or else the back of
+// the first non-empty deque after it. Tasks are never added, so all deques
+// being empty ends the batch.
+static bool popBatchTask(std::vector<BatchQueue>* queues, int t, int* task) {
+    int numQueues = (int)queues->size();
+    for (int k = 0; k < numQueues; ++k) {
+        BatchQueue& queue = (*queues)[(t + k) % numQueues];
+        std::lock_guard<std::mutex> lock(queue._mutex);
+        if (queue._tasks.empty()) {
+            continue;
+        }
+        if (k == 0) {
+            *task = queue._tasks.front();
+            queue._tasks.pop_front();
+        } else {
+            *task = queue._tasks.back();
+            queue._tasks.pop_back();
+        }
+        return true;
+    }
+    return false;
+}
+
+#ifdef __linux__
+// Ids of a sysfs list such as "0-3,8,10-11".
+static std::vector<int> parseIdList(const std::string& list) {
+    std::vector<int> ids;
+    std::stringstream stream(list);
+    std::string range;
+    while (std::getline(stream, range, ',')) {
+        int first, last;
+        int fields = sscanf(range.c_str(), "%d-%d", &first, &last);
+        if (fields < 1) continue;
+        if (fields == 1) last = first;
+        for (int id = first; id <= last; ++id) {
+            ids.push_back(id);
+        }
+    }
+    return ids;
+}
+
+static std::string readFirstLine(const std::string& path) {
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    return line;
+}
+
+// The CPUs of ${allowed} in pinning order: interleaved over the NUMA nodes of
+// /sys/devices/system/node (the first CPU of each node, then the second, ...),
+// so that consecutive workers spread over the nodes. In CPU id order if the
+// node topology is not available.
+static void numaInterleavedCpus(const cpu_set_t& allowed, std::vector<int>* cpus) {
+    std::vector<std::vector<int>> nodeCpus;
+    std::string nodeDir = "/sys/devices/system/node/";
+    for (int node : parseIdList(readFirstLine(nodeDir + "online"))) {
+        std::vector<int> ids;
+        std::string path = nodeDir + "node" + std::to_string(node) + "/cpulist";
+        for (int cpu : parseIdList(readFirstLine(path))) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &allowed)) {
+                ids.push_back(cpu);
+            }
+        }
+        if (!ids.empty()) {
+            nodeCpus.push_back(ids);
+        }
+    }
+    cpus->clear();
+    for (int r = 0; ; ++r) {
+        int added = 0;
+        for (int node = 0; node < nodeCpus.size(); ++node) {
+            if (r < nodeCpus[node].size()) {
+                cpus->push_back(nodeCpus[node][r]);
+                ++added;
+            }
+        }
+        if (added == 0) break;
+    }
+    if (cpus->empty()) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &allowed)) {
+                cpus->push_back(cpu);
+            }
+        }
+    }
+}
+#endif
+
+void KKTSolver::solveBatch(const std::vector<const InputData*>& problems,
+                           std::vector<std::vector<data_type>>* solutions,
+                           int numThreads, bool pinThreads) {
+    assert(solutions != NULL && numThreads >= 1);
+    int count = (int)problems.size();
+    solutions->resize(count);
+    int numWorkers = std::max(1, std::min(numThreads, count));
+    // Longest first, so that the stolen tail is made of short problems.
+    std::vector<int> order(count);
+    for (int k = 0; k < count; ++k) {
+        order[k] = k;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        return problems[a]->_n > problems[b]->_n;
+    });
+    std::vector<BatchQueue> queues(numWorkers);
+    for (int k = 0; k < count; ++k) {
+        queues[k % numWorkers]._tasks.push_back(order[k]);
+    }
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t allowed;
+    if (pinThreads && numWorkers > 1 &&
+        sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        numaInterleavedCpus(allowed, &cpus);
+    }
+#endif
+    auto worker = [&](int t) {
+#ifdef __linux__
+        if (!cpus.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cpus[t % cpus.size()], &set);
+            pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+        }
+#endif
+        OutputData workspace;
+        int k;
+        while (popBatchTask(&queues, t, &k)) {
+            const InputData& inputData = *problems[k];
+            workspace.resize(inputData);
+            // The workers already take the threads: serial engines only.
+            solveAuto(inputData, &workspace, 1);
+            (*solutions)[k].assign(workspace._x, workspace._x + inputData._n);
+        }
+    };
+    if (numWorkers == 1) {
+        // The calling thread is never pinned.
+        worker(0);
+        return;
+    }
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numWorkers; ++t) {
+        threads.push_back(std::thread(worker, t));
+    }
+    for (int t = 0; t < numWorkers; ++t) {
+        threads[t].join();
     }
 }
@@ -15,9 +15,15 @@
 #ifndef kkt_h
 #define kkt_h
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <climits>
 #include <cstdlib>
+#include <deque>
+#include <functional>
 #include <map>
+#include <string>
 #include <vector>
 
 typedef signed long long time_ms_type;  // at least 64 bits.
@@ -30,6 +36,9 @@ const data_type KKT_DRVT_ESP = 1e-6;
 const data_type KKT_INFINITY = 1e10;
 const data_type KKT_LB = -1e4;  // Uniform solution bounds for all problems.
 const data_type KKT_UB = 1e4;
+const int TV_TILE_WIDTH = 16;  // Lines per blocked transpose in solveLines.
+// Smallest first galloping step of solveSweep, in units of _solEsp.
+const data_type SWEEP_MIN_STEP = 16;
 
 // Input data for the generalized total variation model.
 struct InputData {
@@ -66,6 +75,31 @@ struct InputData {
     data_type* _huberD = NULL;
     data_type* _huberS = NULL;
 
+    // Isotonic constraints x_i <= x_{i+1}, on top of the separation terms.
+    // For plain isotonic regression use q = 1 with _cSep[i] = 0.
+    bool _isotonic = false;
+
+    // Rooted tree instead of the chain (see setTree): node 0 is the root and
+    // _parent[i] < i. The edge (i, _parent[i]) carries the separation term
+    // h_{i-1}(x_i - x_{_parent[i]}), so _parent[i] = i - 1 is the chain.
+    // Children of v, in CSR form: _children[_childStart[v] .. _childStart[v + 1]).
+    int* _parent = NULL;
+    int* _childStart = NULL;
+    int* _children = NULL;
+
+    // Arrays borrowed from the caller (view constructors, borrow()): they are
+    // neither copied nor freed, and must outlive the InputData.
+    typedef enum ARRAY_TYPE {
+        ARRAY_CDEV = 1,
+        ARRAY_ADEV = 2,
+        ARRAY_CSEP = 4,
+        ARRAY_PW = 8,
+        ARRAY_BKP_NUMS = 16,
+        ARRAY_HUBER_D = 32,
+        ARRAY_HUBER_S = 64,
+    } array_type;
+    unsigned _borrowed = 0;  // Bitmask of array_type.
+
     // Algorithm parameters
     data_type _lb, _ub;  // Solution lower and upper bounds.
     data_type _solEsp;  // Solution accuracy.
@@ -102,42 +136,67 @@ struct InputData {
         _p = pwDeg;
         _q = 1;  // Currently only support L1-TV.
         _bkpNums = (int*)malloc(_n * sizeof(int));
-        data_type bkp_lb = KKT_INFINITY;
-        data_type bkp_ub = -KKT_INFINITY;
-        int totalBkps = 0;
-        for (int i = 0; i < _n; ++i) {
-            assert(bkpNums[i] >= 0);
-            _bkpNums[i] = bkpNums[i];
-            totalBkps += bkpNums[i];
-        }
-        assert((_pwDeg + 1) * totalBkps + _pwDeg * _n == pw.size());
+        std::copy(bkpNums.begin(), bkpNums.end(), _bkpNums);
+        assert(pwSize(_n, _pwDeg, _bkpNums) == pw.size());
         _pw = (data_type*)malloc(pw.size() * sizeof(data_type));
-        int pwIndex = 0;
-        for (int i = 0; i < _n; ++i) {
-            for (int j = 0; j < _pwDeg; ++j) {
-                _pw[pwIndex] = pw[pwIndex];
-                pwIndex++;
-            }
-            for (int j = 0; j < bkpNums[i]; ++j) {
-                for (int k = 0; k < _pwDeg + 1; ++k) {
-                    _pw[pwIndex] = pw[pwIndex];
-                    if (k == 0) {
-                        // Update lower and upper bound.
-                        data_type bkp = _pw[pwIndex];
-                        if (bkp < bkp_lb) bkp_lb = bkp;
-                        if (bkp > bkp_ub) bkp_ub = bkp;
-                    }
-                    pwIndex++;
-                }
-            }
-        }
+        std::copy(pw.begin(), pw.end(), _pw);
         // Left separation parameter
         _cSep = (data_type*)calloc((_n - 1), sizeof(data_type));
-        _lb = KKT_LB; // Use uniform lower and upper bounds for all problems.
-        _ub = KKT_UB;
-        _solEsp = KKT_SOL_ESP;
-        _drvtEsp = KKT_DRVT_ESP;
-        _infinity = KKT_INFINITY;
+        initAlgParams();
+    }
+
+    // View over caller-owned arrays: ${cDev} and ${aDev} (and ${huberD} for
+    // HUBER_D) of n values, ${cSep} (and ${huberS} for HUBER_S) of n - 1.
+    // Nothing is copied, and the destructor frees none of them.
+    InputData(int n, int p, int q, deviation_type deviationType,
+              separation_type separationType, data_type* cDev, data_type* aDev,
+              data_type* cSep, data_type* huberD = NULL, data_type* huberS = NULL):
+        _n(n), _deviationType(deviationType), _separationType(separationType),
+        _p(p), _q(q), _cDev(cDev), _aDev(aDev), _cSep(cSep),
+        _huberD(huberD), _huberS(huberS) {
+        assert(n >= 1 && p >= 1 && q >= 1);
+        assert(deviationType != PIECEWISE_LP);
+        assert(cDev != NULL && aDev != NULL && (cSep != NULL || n == 1));
+        assert((deviationType == HUBER_D) == (huberD != NULL));
+        assert((separationType == HUBER_S) == (huberS != NULL));
+        if (_deviationType == HUBER_D) {
+            _p = 2;
+        }
+        if (_separationType == HUBER_S) {
+            _q = 2;
+        }
+        _borrowed = ARRAY_CDEV | ARRAY_ADEV | ARRAY_CSEP |
+            (huberD != NULL ? ARRAY_HUBER_D : 0) | (huberS != NULL ? ARRAY_HUBER_S : 0);
+        initAlgParams();
+    }
+
+    // View over caller-owned lp-lq arrays.
+    InputData(int n, int p, int q, data_type* cDev, data_type* aDev, data_type* cSep):
+        InputData(n, p, q, LP, LQ, cDev, aDev, cSep) {}
+
+    // View for piecewise deviations over caller-owned ${bkpNums} (n values)
+    // and ${pw} (laid out as for the constructor above). _cSep is allocated
+    // (zero) unless ${cSep} is given.
+    InputData(int n, int pwDeg, int* bkpNums, data_type* pw,
+              data_type* cSep = NULL) {
+        assert(n >= 1 && bkpNums != NULL && pw != NULL);
+        assert(pwDeg == 1 || pwDeg == 2);  // Currently only support piecewise l1 and l2.
+        _n = n;
+        _pwDeg = pwDeg;
+        _deviationType = PIECEWISE_LP;
+        _separationType = LQ;
+        _p = pwDeg;
+        _q = 1;  // Currently only support L1-TV.
+        _bkpNums = bkpNums;
+        _pw = pw;
+        _borrowed = ARRAY_BKP_NUMS | ARRAY_PW;
+        if (cSep != NULL) {
+            _cSep = cSep;
+            _borrowed |= ARRAY_CSEP;
+        } else {
+            _cSep = (data_type*)calloc((_n - 1), sizeof(data_type));
+        }
+        initAlgParams();
     }
 
     InputData(int n, int p, int q, deviation_type deviationType,
@@ -160,59 +219,226 @@ struct InputData {
     }
 
     ~InputData() {
-        if (_cDev != NULL)
-            free(_cDev);
-        if (_aDev != NULL)
-            free(_aDev);
-        if (_cSep != NULL)
-            free(_cSep);
-        if (_pw != NULL)
-            free(_pw);
-        if (_bkpNums != NULL)
-            free(_bkpNums);
-        if (_huberD != NULL) {
-            free(_huberD);
+        release(ARRAY_CDEV);
+        release(ARRAY_ADEV);
+        release(ARRAY_CSEP);
+        release(ARRAY_PW);
+        release(ARRAY_BKP_NUMS);
+        release(ARRAY_HUBER_D);
+        release(ARRAY_HUBER_S);
+        if (_parent != NULL) {
+            free(_parent);
+            free(_childStart);
+            free(_children);
         }
-        if (_huberS != NULL) {
-            free(_huberS);
+    }
+
+    // Sets the tree by its parent array (parent[0] = -1, parent[i] < i) and
+    // builds the CSR child lists, children in increasing index order.
+    void setTree(const std::vector<int>& parent) {
+        assert(parent.size() == _n && parent[0] == -1);
+        if (_parent == NULL) {
+            _parent = (int*)malloc(_n * sizeof(int));
+            _childStart = (int*)malloc((_n + 1) * sizeof(int));
+            _children = (int*)malloc(_n * sizeof(int));
+        }
+        for (int i = 0; i <= _n; ++i) {
+            _childStart[i] = 0;
+        }
+        _parent[0] = -1;
+        for (int i = 1; i < _n; ++i) {
+            assert(parent[i] >= 0 && parent[i] < i);
+            _parent[i] = parent[i];
+            _childStart[parent[i] + 1]++;
+        }
+        for (int i = 0; i < _n; ++i) {
+            _childStart[i + 1] += _childStart[i];
+        }
+        std::vector<int> next(_childStart, _childStart + _n);
+        for (int i = 1; i < _n; ++i) {
+            _children[next[_parent[i]]++] = i;
+        }
+    }
+
+    bool owns(array_type array) const {
+        return !(_borrowed & array);
+    }
+
+    // Points ${array} at the caller-owned ${buffer}, of the array's size,
+    // freeing the array it replaces if owned.
+    void borrow(array_type array, data_type* buffer) {
+        assert(array != ARRAY_BKP_NUMS && buffer != NULL);
+        release(array);
+        *field(array) = buffer;
+        _borrowed |= array;
+    }
+    void borrow(int* bkpNums) {
+        assert(bkpNums != NULL);
+        release(ARRAY_BKP_NUMS);
+        _bkpNums = bkpNums;
+        _borrowed |= ARRAY_BKP_NUMS;
+    }
+
+    // Number of values in _pw for the breakpoint counts ${bkpNums}.
+    static size_t pwSize(int n, int pwDeg, const int* bkpNums) {
+        size_t totalBkps = 0;
+        for (int i = 0; i < n; ++i) {
+            assert(bkpNums[i] >= 0);
+            totalBkps += bkpNums[i];
         }
+        return (pwDeg + 1) * totalBkps + (size_t)pwDeg * n;
     }
 
     void initParams() {
         _cDev = (data_type*)calloc(_n, sizeof(data_type));
         _aDev = (data_type*)calloc(_n, sizeof(data_type));
         _cSep = (data_type*)calloc((_n - 1), sizeof(data_type));
-        _lb = KKT_LB;
+        initAlgParams();
+    }
+
+    void initAlgParams() {
+        _lb = KKT_LB;  // Use uniform lower and upper bounds for all problems.
         _ub = KKT_UB;
         _solEsp = KKT_SOL_ESP;
         _drvtEsp = KKT_DRVT_ESP;
         _infinity = KKT_INFINITY;
     }
+
+private:
+    data_type** field(array_type array) {
+        switch (array) {
+            case ARRAY_CDEV: return &_cDev;
+            case ARRAY_ADEV: return &_aDev;
+            case ARRAY_CSEP: return &_cSep;
+            case ARRAY_PW: return &_pw;
+            case ARRAY_HUBER_D: return &_huberD;
+            case ARRAY_HUBER_S: return &_huberS;
+            default:
+                assert(false);
+                return NULL;
+        }
+    }
+
+    // Frees ${array} if owned, and forgets it either way.
+    void release(array_type array) {
+        if (array == ARRAY_BKP_NUMS) {
+            if (owns(array) && _bkpNums != NULL) {
+                free(_bkpNums);
+            }
+            _bkpNums = NULL;
+        } else {
+            data_type** ptr = field(array);
+            if (owns(array) && *ptr != NULL) {
+                free(*ptr);
+            }
+            *ptr = NULL;
+        }
+        _borrowed &= ~array;
+    }
+};
+
+// Engines that solveAuto can dispatch to.
+typedef enum KKT_ENGINE {
+    ENGINE_NONE = 0,  // Not chosen by solveAuto.
+    ENGINE_SOLVE,
+    ENGINE_DP,
+    ENGINE_FAST_L2_L1,
+    ENGINE_CONDAT,
+    ENGINE_TAUT_STRING,
+    ENGINE_FAST_L1_L1,
+    ENGINE_FAST_HUBER_L1,
+    ENGINE_FAST_L2_HUBER,
+    ENGINE_FAST_PWL1_L1,
+    ENGINE_FAST_PWL2_L1,
+    ENGINE_FAST_L2_L2,
+    ENGINE_FAST_L2_L2_PARALLEL,
+    ENGINE_SPARSE,
+    ENGINE_PAV,
+    ENGINE_TREE,
+} kkt_engine;
+
+// Map from engine to string for output.
+std::string toString(kkt_engine engine);
+
+// One row of the solveAuto selection table. Rows are scanned in order; the
+// first row whose engine applies to the input and whose ranges contain it wins.
+struct KKTEngineRule {
+    kkt_engine _engine;
+    int _minN = 1;
+    int _maxN = INT_MAX;
+    data_type _maxAveBkps = KKT_INFINITY;  // Average breakpoints per node.
+
+    KKTEngineRule(kkt_engine engine, int minN = 1, int maxN = INT_MAX,
+                  data_type maxAveBkps = KKT_INFINITY):
+        _engine(engine), _minN(minN), _maxN(maxN), _maxAveBkps(maxAveBkps) {}
+};
+
+// Per-node solution bounds in one flat buffer: bounds[i][0] and bounds[i][1]
+// are the lower and upper bound of node i. Replaces n two-element vectors,
+// so construction is one allocation and reset() one contiguous fill.
+class NodeBounds {
+public:
+    NodeBounds() {}
+    NodeBounds(int n, data_type lb, data_type ub) {
+        resize(n, lb, ub);
+    }
+
+    data_type* operator [] (int i) {
+        assert(i >= 0 && i < _size);
+        return &_data[2 * i];
+    }
+    const data_type* operator [] (int i) const {
+        assert(i >= 0 && i < _size);
+        return &_data[2 * i];
+    }
+
+    int size() const { return _size; }
+    // Capacity of the buffer, which only grows.
+    int capacity() const { return (int)_data.size() / 2; }
+
+    // Resizes to ${n} nodes, all reset to [lb, ub].
+    void resize(int n, data_type lb, data_type ub) {
+        if (n > capacity()) {
+            _data.resize(2 * n);
+        }
+        _size = n;
+        reset(lb, ub);
+    }
+
+    void reset(data_type lb, data_type ub) {
+        for (int i = 0; i < _size; ++i) {
+            _data[2 * i] = lb;
+            _data[2 * i + 1] = ub;
+        }
+    }
+
+private:
+    std::vector<data_type> _data;
+    int _size = 0;
 };
 
 // Output data for the generalized total variation model.
 struct OutputData {
     int _n;
     data_type* _x = NULL;
+    // Allocated length of _x, which resize() only grows.
+    int _capacity = 0;
     data_type _objVal;
     // Save divergent values.
-    std::vector<std::vector<data_type>> _bounds;
+    NodeBounds _bounds;
     // For piecewise deviation functions.
     int _stIndex;
+    // Engine chosen by solveAuto.
+    kkt_engine _engine = ENGINE_NONE;
 
     OutputData() {}
 
-    OutputData(const InputData& inputData) {
+    OutputData(const InputData& inputData):
+        _bounds(inputData._n, inputData._lb, inputData._ub) {
         _n = inputData._n;
-        _x = (data_type*)calloc(_n, sizeof(data_type));
+        _x = (data_type*)calloc((size_t)std::max(_n, 1), sizeof(data_type));
+        _capacity = _n;
         _objVal = 0;
-        // Rolling buffers.
-        std::vector<data_type> item(2, 0);
-        item[0] = inputData._lb;
-        item[1] = inputData._ub;
-        for (int i = 0; i < _n; ++i) {
-            _bounds.push_back(item);
-        }
         _stIndex = 0;
     }
 
@@ -221,6 +447,30 @@ struct OutputData {
             free(_x);
     }
 
+    // Restores the initial bounds, to solve another input of the same size.
+    void reset(const InputData& inputData) {
+        assert(inputData._n == _n);
+        _bounds.reset(inputData._lb, inputData._ub);
+        _stIndex = 0;
+    }
+
+    // Re-targets the output at an input of any size, reusing the buffers
+    // (which only grow): x is zeroed and the bounds restored, as if freshly
+    // constructed from ${inputData}.
+    void resize(const InputData& inputData) {
+        int n = inputData._n;
+        if (n > _capacity) {
+            _x = (data_type*)realloc(_x, n * sizeof(data_type));
+            _capacity = n;
+        }
+        _bounds.resize(n, inputData._lb, inputData._ub);
+        _n = n;
+        std::fill(_x, _x + n, 0);
+        _objVal = 0;
+        _engine = ENGINE_NONE;
+        _stIndex = 0;
+    }
+
     void operator = (const OutputData& other) {
         if (_x != NULL) {
             free(_x);
@@ -228,34 +478,387 @@ struct OutputData {
 
         _n = other._n;
         _x = (data_type*)calloc(_n, sizeof(data_type));
+        _capacity = _n;
         for (int i = 0; i < _n; ++i) {
             _x[i] = other._x[i];
         }
         _objVal = 0;
         _bounds = other._bounds;
         _stIndex = other._stIndex;
+        _engine = other._engine;
+    }
+};
+
+// Alignment of the KKTWorkspace buffers, in bytes.
+const int KKT_WORKSPACE_ALIGNMENT = 64;
+
+// Reusable input and output for repeated lp-lq solves of varying n, as in a
+// service loop: the coefficient arrays, x and the bounds are owned by the
+// workspace, aligned to KKT_WORKSPACE_ALIGNMENT, and only grow (to the
+// largest n seen), so a warm workspace solves without allocating.
+class KKTWorkspace {
+public:
+    KKTWorkspace(): _input(1), _output(_input) {}
+    KKTWorkspace(const KKTWorkspace&) = delete;
+    KKTWorkspace& operator = (const KKTWorkspace&) = delete;
+
+    // Re-targets the workspace at an n-node lp-lq input, growing the buffers
+    // if needed, in O(1) otherwise. The first n coefficients hold stale
+    // values and are to be filled in by the caller; the algorithm
+    // parameters (_lb, _ub, _solEsp, ...) persist across solves.
+    InputData& prepare(int n, int p, int q);
+
+    InputData& input() { return _input; }
+    const OutputData& output() const { return _output; }
+    OutputData& output() { return _output; }
+
+    // Restores the output bounds to [_lb, _ub] of the input before a solve.
+    // O(n), a contiguous fill: epoch-stamped bounds made this O(1) but cost a
+    // stamp check on every bound access, and solve() ran 7-24% slower.
+    void restart() {
+        _output._n = _input._n;
+        _output._bounds.resize(_input._n, _input._lb, _input._ub);
+        _output._objVal = 0;
+        _output._stIndex = 0;
+    }
+
+    int capacity() const { return _capacity; }
+    // Number of buffer (re)allocations since construction.
+    long long numAllocations() const { return _numAllocations; }
+
+private:
+    InputData _input;
+    OutputData _output;
+    int _capacity = 0;  // Nothing aligned yet.
+    long long _numAllocations = 0;
+};
+
+// LDL^T factorization of the tridiagonal l2-l2 optimality system
+//   c_i(x_i - a_i) + c_{i-1,i}(x_i - x_{i-1}) + c_{i,i+1}(x_i - x_{i+1}) = 0,
+// for solving repeatedly with different _aDev (fixed _cDev and _cSep).
+struct L2L2Factor {
+    int _n = 0;
+    std::vector<data_type> _l;  // Sub-diagonal of the unit lower triangular L.
+    std::vector<data_type> _invD;  // Inverse of the diagonal D.
+    std::vector<data_type> _cDev;  // Right-hand side weights.
+};
+
+// A segment [_first, _last] of the l2-l1 solution path: all its nodes take
+// the value _alpha - _beta * lambda for lambda in [_birth, _death).
+struct L2L1PathNode {
+    int _first, _last;
+    data_type _birth, _death;
+    data_type _alpha, _beta;
+    int _left, _right;  // The two merged segments; -1 for single nodes.
+};
+
+// Exact solution path of the l2-l1 problem over a uniform separation
+// coefficient lambda, built by KKTSolver::l2_l1_path. Segments only merge as
+// lambda grows, so the path is a forest of merges over the single nodes.
+struct L2L1Path {
+    int _n = 0;
+    data_type _lb, _ub;
+    std::vector<L2L1PathNode> _nodes;  // Single nodes first, then merges in lambda order.
+    std::vector<int> _roots;  // Segments that never merge, left to right.
+
+    // Indices into _nodes of the segments at ${lambda}, left to right,
+    // in O(#segments).
+    void segments(data_type lambda, std::vector<int>* out) const;
+    // The solution at ${lambda}, clipped to [_lb, _ub].
+    void solution(data_type lambda, OutputData* result) const;
+};
+
+// l2-l1 problem of at most MaxN nodes in inline buffers, so that it can live
+// on the stack: filling and solving it (KKTSolver::solveSmall) allocates
+// nothing, where InputData callocs five arrays and OutputData n bound vectors.
+template <int MaxN>
+struct SmallL2L1 {
+    int _n;
+    data_type _cDev[MaxN];
+    data_type _aDev[MaxN];
+    data_type _cSep[MaxN];  // The first _n - 1 are used.
+    data_type _x[MaxN];
+    data_type _lb = KKT_LB, _ub = KKT_UB;
+    data_type _solEsp = KKT_SOL_ESP;
+
+    explicit SmallL2L1(int n = MaxN): _n(n) {
+        assert(n >= 1 && n <= MaxN);
     }
 };
 
 // KKT Solver
 class KKTSolver {
 public:
+    KKTSolver(): _engineRules(defaultEngineRules()) {}
+
     // Main generic compute function.
     void solve(const InputData& inputData, OutputData* result);
+    // solve() on the input prepared in ${workspace}, into its output.
+    void solve(KKTWorkspace* workspace);
+
+    // Dispatch to the fastest engine that applies to the input, by the first
+    // matching row of the engine table; falls back to solve(). The chosen
+    // engine is recorded in result->_engine. The parallel engines use at most
+    // ${numThreads} threads (0: all cores); with 1, only serial engines apply,
+    // e.g. inside worker threads.
+    void solveAuto(const InputData& inputData, OutputData* result,
+                   int numThreads = 0);
+
+    // Engine table calibrated from the comparison profiles. Override it with
+    // setEngineRules, e.g. from a re-run of the profiles on the target machine.
+    static std::vector<KKTEngineRule> defaultEngineRules();
+    void setEngineRules(const std::vector<KKTEngineRule>& rules) {
+        _engineRules = rules;
+    }
+    const std::vector<KKTEngineRule>& engineRules() const {
+        return _engineRules;
+    }
+
+    // Warm-started sweep over separation scalings: solves ${inputData} with
+    // _cSep scaled by scales[0], scales[1], ... in turn (restored on return)
+    // and streams each solution to ${callback}(k, scaled input, solution).
+    // Each node's search starts at its previous solution and gallops with a
+    // doubling step, starting from its previous change, until a probe flips
+    // direction; the bracket it has then probed on both ends is bisected.
+    // The divergence bounds stay those of solve(), so no bracket is assumed.
+    void solveSweep(InputData* inputData, const std::vector<data_type>& scales,
+                    const std::function<void(int, const InputData&,
+                                             const OutputData&)>& callback);
+
+    // Message-passing dynamic programming solver for l1 separations
+    // (Kolmogorov / Johnson style), for lp deviations with p = 1, 2 and
+    // piecewise linear / quadratic deviations. The derivative of each forward
+    // message is piecewise affine: its two end pieces plus a sorted map of
+    // breakpoint increments. Clamping it to [-c_{i,i+1}, c_{i,i+1}] pops
+    // breakpoints from both ends, so the run time is O(m log m) in the total
+    // number of breakpoints, independent of the bisection depth.
+    void dp_solve(const InputData& inputData, OutputData* result);
 
     // Fast l2_l1 solver, working for both unweighted and weighted,
     // by adapting the general versions of the KKT algorithms.
     void fast_l2_l1(const InputData& inputData, OutputData* result);
+    // fast_l2_l1 on the input prepared in ${workspace}, into its output.
+    void fast_l2_l1(KKTWorkspace* workspace);
+
+    // Heap-free fast_l2_l1 for small n: the same propagation on caller-owned
+    // arrays (n, n, n - 1 coefficients) with the bounds [lb, ub] for all nodes.
+    // The _fixed variant has n = N at compile time, for
+    // N = 8, 16, 32, ..., 1024.
+    void fast_l2_l1(int n, const data_type* cDev, const data_type* aDev,
+                    const data_type* cSep, data_type lb, data_type ub,
+                    data_type solEsp, data_type* x);
+    template <int N>
+    void fast_l2_l1_fixed(const data_type* cDev, const data_type* aDev,
+                          const data_type* cSep, data_type lb, data_type ub,
+                          data_type solEsp, data_type* x);
+    template <int MaxN>
+    void solveSmall(SmallL2L1<MaxN>* problem) {
+        fast_l2_l1(problem->_n, problem->_cDev, problem->_aDev, problem->_cSep,
+                   problem->_lb, problem->_ub, problem->_solEsp, problem->_x);
+    }
+
+    // Solution path of l2_l1 over lambda = _cSep[i] for all i (_cSep is not
+    // read), for lambda sweeps. Between merges every segment has fixed signs
+    // against its neighbors, so its value is affine in lambda; the merges are
+    // popped from a heap of meeting points of adjacent segments: O(n log n).
+    // Requires _cDev[i] > 0.
+    void l2_l1_path(const InputData& inputData, L2L1Path* path);
+
+    // Reference l2_l1 engines for head-to-head benchmarking.
+    // Condat's direct algorithm (L. Condat, "A direct algorithm for 1D total
+    // variation denoising", 2013). Requires uniform _cDev and _cSep.
+    void condat_l2_l1(const InputData& inputData, OutputData* result);
+
+    // Taut string on the cumulative sums R_k = \sum_{i<k} c_ix_i, which must
+    // stay within _cSep[k-1] of \sum_{i<k} c_ia_i; x_i is the slope of the
+    // string over [\sum_{j<i} c_j, \sum_{j<=i} c_j]. Handles weighted _cDev and
+    // _cSep in O(n) amortized.
+    void taut_string_l2_l1(const InputData& inputData, OutputData* result);
+
+    // Fast l1_l1 solver (L1-TV), in the style of fast_l2_l1.
+    // Deviation derivatives are piecewise constant, so the accumulated
+    // derivative is kept as the sum over nodes whose sign is settled by the
+    // current search interval, plus the short list of undetermined nodes.
+    void fast_l1_l1(const InputData& inputData, OutputData* result);
+
+    // Fast Huber_l1 solver (Huber-TV), in the style of fast_l2_l1.
+    // Huber derivatives are affine inside [a - k, a + k] and constant outside,
+    // so nodes whose regime is settled by the current search interval are
+    // accumulated as a coefficient/constant pair, and only the nodes whose
+    // regime depends on x are evaluated with huberDrvt.
+    void fast_huber_l1(const InputData& inputData, OutputData* result);
+
+    // Fast l2_Huber solver.
+    // Same propagation and bound bookkeeping as solve(), specialized for
+    // quadratic deviations and Huber separations: the accumulated derivative
+    // is a running sum of c_j * (x_j - a_j), and the Huber inverse is applied
+    // inline without the InputData type dispatch.
+    void fast_l2_huber(const InputData& inputData, OutputData* result);
+
+    // Fast piecewise-linear / piecewise-quadratic deviations + l1 solvers,
+    // in the style of fast_l2_l1. Per-node offsets into _pw are prefix-summed
+    // once. Nodes whose piece is settled by the current search interval are
+    // accumulated as a coefficient/constant pair; only the others are looked
+    // up with getPQIndex at each probe.
+    void fast_pwl1_l1(const InputData& inputData, OutputData* result);
+    void fast_pwl2_l1(const InputData& inputData, OutputData* result);
+
+    // Direct O(n) l2_l2 solver (L2-Tikhonov) by the Thomas algorithm.
+    void fast_l2_l2(const InputData& inputData, OutputData* result);
+
+    // Factor once, then solve for any number of _aDev vectors.
+    void factor_l2_l2(const InputData& inputData, L2L2Factor* factor);
+    void solve_l2_l2(const L2L2Factor& factor, const data_type* aDev,
+                     OutputData* result);
+
+    // Partitioned (SPIKE) l2_l2 solver on ${numThreads} threads.
+    // Each block is factored and solved concurrently, a reduced system couples
+    // the block end points, and the blocks are finalized concurrently.
+    void fast_l2_l2_parallel(const InputData& inputData, OutputData* result,
+                             int numThreads);
 
     // Fast linear_l2 solver (1D graph Laplacian solver)
     // Problem:
-    // min_{x_i} \sum_{i=1}^n c_ix_i + 0.5 * \sum_{i=1}^{n-1}(x_i - x_{i+1})^2.
+    // min_{x_i} \sum_{i=1}^n c_ix_i + 0.5 * \sum_{i=1}^{n-1}c_{i,i+1}(x_i - x_{i+1})^2,
+    // with c_{i,i+1} = _cSep[i] > 0. Requires \sum_i c_i = 0; fixes x_1 = 0.
     void fast_linear_l2(const InputData& inputData, OutputData* result);
+    // fast_linear_l2 on the input prepared in ${workspace}, into its output.
+    void fast_linear_l2(KKTWorkspace* workspace);
+
+    // Anchored variant: x_{anchorIndex} = anchorValue, \sum_i c_i arbitrary
+    // (the anchor absorbs the imbalance). The two prefix scans (of c_i, and of
+    // the weighted increments) run as a two-pass blocked scan on ${numThreads}.
+    void fast_linear_l2(const InputData& inputData, OutputData* result,
+                        int anchorIndex, data_type anchorValue,
+                        int numThreads = 1);
+
+    // Solves the 1D problem with uniform coefficients,
+    //   \sum_i (c/p)|x_i - a_i|^p + \sum_i (lambda/q)|x_i - x_{i+1}|^q,
+    // on every line along ${axis} of the row-major array ${a} of extents ${dims},
+    // into ${x} (which may alias ${a}). Lines are solved by fast_l2_l1 for
+    // p = 2, q = 1 and by solve() otherwise, on ${numThreads} threads with one
+    // InputData / OutputData per thread. Strided axes are gathered
+    // TV_TILE_WIDTH lines at a time by a blocked transpose, so that the sweep
+    // reads and writes contiguous runs.
+    void solveLines(const std::vector<int>& dims, int axis, const data_type* a,
+                    data_type* x, int p, int q, data_type c, data_type lambda,
+                    int numThreads);
+
+    // Anisotropic N-D TV prox (images, volumes):
+    //   argmin_x (c/2)||x - y||^2 + \sum_d lambdas[d] TV_d(x),
+    // with TV_d the l1 differences along axis d, by ${iters} rounds of the
+    // parallel Dykstra-like splitting over the axis proxes (Combettes and
+    // Pesquet), each a solveLines sweep. Keeps dims.size() + 1 work arrays.
+    void tv_prox(const std::vector<int>& dims, const data_type* y, data_type c,
+                 const std::vector<data_type>& lambdas, data_type* x, int iters,
+                 int numThreads);
+
+    // Tree solver (InputData::setTree) for l1 separations and the deviations
+    // of dp_solve. Generalizes the chain propagation to the tree: in post-order,
+    // the derivative of each subtree, as a function of its root value, is the
+    // node's deviation derivative plus the clamped derivatives of its child
+    // subtrees; the clamp points give x_v = clip(x_{parent}) top-down.
+    // Child breakpoint maps are merged small-to-large: O(m log^2 m).
+    void solveTree(const InputData& inputData, OutputData* result);
+
+    // Pool adjacent violators solver for isotonic inputs with LP or HUBER_D
+    // deviations and l1 separations. On a non-decreasing x the separations
+    // are linear, \sum c_{i,i+1}(x_{i+1} - x_i), so they fold into the
+    // deviation derivatives. Blocks of quadratic deviations are pooled in O(1);
+    // other blocks are solved by bisection on the block derivative.
+    void pav_solve(const InputData& inputData, OutputData* result);
+
+    // Solver for inputs with missing observations (_cDev[i] = 0).
+    // Each run of unobserved nodes is collapsed into a single edge whose
+    // separation coefficient is the inf-convolution of the run's lq terms:
+    //   q = 1: min_k c_k;  q > 1: (\sum_k c_k^{-1/(q-1)})^{-(q-1)}.
+    // The compressed problem is solved and the gaps are filled analytically.
+    // Supports LP and HUBER_D deviations with LQ separations.
+    void solveSparse(const InputData& inputData, OutputData* result);
+
+    // Domain-decomposition solve of one long chain on ${numThreads} threads:
+    // the chain is cut into numThreads blocks, solved concurrently by
+    // single-threaded solveAuto() with the cut edges dropped. Re-attaching the
+    // cut edges is then a set of local edits, which resolveRange() solves
+    // exactly around each cut, the windows of all cuts concurrently (windows
+    // grow while the edge derivatives do not match; grown windows that meet
+    // merge, so the fix-up is serial in the worst case). Same input types as
+    // resolve().
+    void solveParallel(const InputData& inputData, OutputData* result,
+                       int numThreads);
+
+    // Two-thread solve(): one thread fixes nodes from 0 upwards, the other
+    // runs solve() on the reversed chain, fixing nodes from n - 1 downwards.
+    // Each fixed node is published and pinned (collapsed bounds) in the other
+    // direction, whose propagations then stop at the pinned side; they meet
+    // where the next node is already fixed. Same input types as resolve().
+    void solveBidirectional(const InputData& inputData, OutputData* result);
+
+    // Solves the independent problems ${problems} by single-threaded
+    // solveAuto() on a pool of ${numThreads} workers, into ${solutions}
+    // (resized to one x per problem). Problems are dealt round robin, longest
+    // first, to per-worker deques; a worker takes from the front of its own
+    // deque and, once it is empty, steals from the back of the others. Each
+    // worker solves into one OutputData workspace, grown to its longest
+    // problem and reset in between. With ${pinThreads} (Linux), worker t is
+    // pinned to the t-th CPU the process may run on, taken round robin over
+    // the NUMA nodes of /sys/devices/system/node, before it touches its
+    // workspace, so that the workspace is first-touch allocated on the
+    // worker's node and the workers spread over the nodes.
+    // Safe to call concurrently: the solver is not modified.
+    void solveBatch(const std::vector<const InputData*>& problems,
+                    std::vector<std::vector<data_type>>* solutions,
+                    int numThreads, bool pinThreads = false);
+
+    // Incremental re-solve after local edits. ${result} holds the solution of
+    // ${inputData} from before the deviations of ${editedNodes} (_cDev, _aDev,
+    // _huberD) and the separations of ${editedSeps} (_cSep, _huberS) changed,
+    // and is updated in place. Each edit gets a window: its fused segment of
+    // the old solution plus one segment on either side, re-solved by solve()
+    // with x pinned at the two outer neighbors. Across a segment break the
+    // edge derivative h'_i(x_{i+1} - x_i) is known locally, so a window is
+    // accepted when the multipliers started from its left break stay within
+    // the separation subgradients and end on its right break; otherwise it is
+    // doubled (snapped to breaks), merging with its neighbors, up to the full
+    // problem. Supports LP and HUBER_D deviations with LQ and HUBER_S
+    // separations. Returns the number of nodes re-solved.
+    int resolve(const InputData& inputData, OutputData* result,
+                const std::vector<int>& editedNodes,
+                const std::vector<int>& editedSeps);
+
+    // resolve() on the chain of nodes [begin, end) of ${inputData}, with the
+    // solution in x[begin, end). Old values of the overwritten nodes are
+    // recorded in ${oldX} (and read from it where present). The open windows
+    // of each round are solved on up to ${numThreads} threads.
+    int resolveRange(const InputData& inputData, data_type* x, int begin, int end,
+                     const std::vector<int>& editedNodes,
+                     const std::vector<int>& editedSeps,
+                     std::map<int, data_type>* oldX, int numThreads = 1);
 
     // Compute the objective value.
     virtual void compObj(const InputData& inputData, OutputData* outputData);
 
 private:
+    std::vector<KKTEngineRule> _engineRules;
+
+    // solve(), with the first probe of node i at guess[i] and galloping steps
+    // from steps[i] (see solveSweep); bisection from the midpoint if NULL.
+    void solveFrom(const InputData& inputData, OutputData* result,
+                   const data_type* guess, const data_type* steps);
+
+    // The iteration of solveFrom() on node i. Returns true if a propagation
+    // from x_i met the last derivative, which fixes the remaining nodes too.
+    bool solveNode(const InputData& inputData, OutputData* result, int i,
+                   const data_type* guess, const data_type* steps);
+
+    // One direction of solveBidirectional(): solveNode() on nodes 0, 1, ...
+    // until node n - 1 - k is one of the ${otherDone} nodes fixed by the
+    // other direction, whose values are otherX[k] (its own order). Publishes
+    // the number of fixed nodes in ${done}.
+    void solveMeet(const InputData& inputData, OutputData* result,
+                   std::atomic<int>* done, const std::atomic<int>& otherDone,
+                   const data_type* otherX);
+
     // Overridable for your specific fidelity/regularization functions.
 
     // Propagation function
@@ -275,4 +878,95 @@ private:
                                  const data_type& fDrvtValue, int index);
 };
 
+struct DPMessage;
+
+// Streaming l1-separation solver for LP deviations with p = 1, 2, on the
+// forward messages of dp_solve. Nodes arrive in chunks; once node k has
+// arrived, the backward pass gives x_i = clip(x_{i+1}, [low_i, high_i]) for
+// i < k, where only x_k depends on later data. Composing the clips from
+// [low_{k-1}, high_{k-1}] down the frontier, the first interval that
+// collapses to a point fixes that node and every node before it, whatever
+// follows: that prefix is emitted and dropped. Memory is the frontier of
+// unemitted nodes plus the message breakpoints.
+class KKTStream {
+public:
+    KKTStream(int p, data_type lb = KKT_LB, data_type ub = KKT_UB);
+    ~KKTStream();
+    KKTStream(const KKTStream&) = delete;
+    KKTStream& operator = (const KKTStream&) = delete;
+
+    // Appends ${m} nodes with deviations (cDev[j], aDev[j]); cSep[j] weighs
+    // the edge to the next node, which may arrive with the next chunk.
+    // Finalized x values are appended to ${out}, in node order.
+    void push(int m, const data_type* cDev, const data_type* aDev,
+              const data_type* cSep, std::vector<data_type>* out);
+
+    // Ends the stream (the last cSep is ignored) and emits the remaining nodes.
+    void finish(std::vector<data_type>* out);
+
+    // Number of nodes pushed but not emitted.
+    int frontierSize() const { return (int)_lows.size() + (_hasPending ? 1 : 0); }
+    // Number of breakpoints held by the forward message.
+    int numBreakpoints() const;
+
+private:
+    int _p;
+    data_type _lb, _ub;
+    DPMessage* _msg;
+    // Clip intervals of the clamped, unemitted nodes.
+    std::deque<data_type> _lows, _highs;
+    // The last node is added to the message but clamped only once its
+    // successor (or the end of the stream) arrives.
+    bool _hasPending = false;
+    data_type _pendingCSep = 0;
+
+    // Emits x_0 ... x_{last} from x_{last} = ${x}.
+    void emit(int last, data_type x, std::vector<data_type>* out);
+};
+
+// Sliding-window Huber/l2-TV solver for live signals: keeps the solution over
+// the last ${capacity} samples as samples arrive. The samples live in a
+// mirrored ring buffer InputData of 2 * (capacity + 1) nodes, each written at
+// both of its slots, so the window plus the incoming sample is always the
+// contiguous chain [_head, _head + size()]. Appending a sample extends the
+// last segment and dropping the oldest zeroes its _cDev and outgoing _cSep;
+// resolveRange then re-solves only the segments at the two ends.
+class KKTSlidingWindow {
+public:
+    // LP (p = 2) or HUBER_D deviations, l1 separations.
+    KKTSlidingWindow(int capacity,
+                     InputData::deviation_type deviationType = InputData::LP,
+                     data_type lb = KKT_LB, data_type ub = KKT_UB);
+
+    // Loads the last min(n, capacity) nodes of ${inputData} (same deviation
+    // type, q = 1) as the window and solves it from scratch.
+    void assign(const InputData& inputData);
+
+    // Appends a sample with deviation weight ${cDev} around ${aDev} (Huber
+    // parameter ${huberD}) and separation ${cSep} to the previous sample;
+    // drops the oldest sample once the window is full.
+    void push(data_type aDev, data_type cDev = 1, data_type cSep = 1,
+              data_type huberD = 1);
+
+    int size() const { return _size; }
+    // Solution over the window, oldest sample first: size() values.
+    const data_type* solution() const { return _x.data() + _head; }
+    // Copies the window into ${inputData}, of size size().
+    void copyWindow(InputData* inputData) const;
+    // Number of nodes re-solved by the last push.
+    int lastResolved() const { return _lastResolved; }
+
+private:
+    KKTSolver _solver;
+    int _capacity, _period;  // _period = capacity + 1 slots.
+    InputData _data;
+    std::vector<data_type> _x;
+    int _head = 0, _size = 0, _lastResolved = 0;
+
+    // Writes node / edge i and its mirror slot.
+    void setNode(int i, data_type aDev, data_type cDev, data_type huberD);
+    void setSep(int i, data_type cSep);
+    void setX(int i, data_type x);
+};
+
 #endif /* kkt_h */
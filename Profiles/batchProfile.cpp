@@ -0,0 +1,135 @@
+//
+//  batchProfile.cpp
+//  KKT
+//
+
+#include "comparison_profiles.hpp"
+#include <iostream>
+#include <memory>
+#include <thread>
+
+// Problem lengths are log-uniform on [BATCH_MIN_N, BATCH_MAX_N].
+const int BATCH_MIN_N = 10;
+const int BATCH_MAX_N = 10000;
+// Batches of 10, 100, ..., 10^BATCH_MAX_SCALES problems.
+const int BATCH_MAX_SCALES = 4;
+
+// Largest |x - y| over the solutions of two batch solves.
+static data_type batchMaxDiff(const std::vector<std::vector<data_type>>& x,
+                              const std::vector<std::vector<data_type>>& y) {
+    data_type maxDiff = 0;
+    for (int k = 0; k < x.size(); ++k) {
+        if (x[k].size() != y[k].size()) {
+            return KKT_INFINITY;
+        }
+        for (int i = 0; i < x[k].size(); ++i) {
+            maxDiff = std::max(maxDiff, fabs(x[k][i] - y[k][i]));
+        }
+    }
+    return maxDiff;
+}
+
+void batchProfile(int rounds, const std::string& path) {
+    assert(rounds > 0);
+    std::vector<std::vector<time_ms_type>> runTimes;
+    CSV csvData;
+    csvData._problemType = BATCH;
+    csvData._genDataType = KKT_LP_LQ;
+    int numScales = std::min(NUM_SCALES, BATCH_MAX_SCALES);
+    size_t algNum = cpAlgs[csvData._problemType].size();
+    const std::vector<std::string>& cpAlgsList = cpAlgs[csvData._problemType];
+    csvData.init(cpAlgsList, numScales);
+    for (int i = 0; i < algNum; ++i) {
+        runTimes.push_back(std::vector<time_ms_type>(rounds, 0));
+    }
+    int numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+
+    // Case 1: l2-l1 (fast engines); Case 2: l3-l2 (generic solve()).
+    for (int p = 2; p <= 3; ++p) {
+        csvData._p = p;
+        csvData._q = p - 1;
+        std::cout << "Run " << toString(csvData._problemType) << " with data "
+            << toString(csvData._genDataType) << " for l" << csvData._p
+            << "-l" << csvData._q << ", lengths in [" << BATCH_MIN_N << ", "
+            << BATCH_MAX_N << "], varying batch size, " << numThreads
+            << " threads" << std::endl;
+        int count = 1;
+        for (int i = 0; i < numScales; ++i) {
+            count *= 10;
+            csvData._colTitles[i] = count;
+            std::cout << "count = " << count << std::endl;
+            long long totalN = 0;
+            for (int iter = 0; iter < rounds; ++iter) {
+                std::vector<int> lengths;
+                genBatchLengths(count, BATCH_MIN_N, BATCH_MAX_N, &lengths);
+                std::vector<std::unique_ptr<InputData>> inputData(count);
+                std::vector<const InputData*> problems(count);
+                totalN = 0;
+                for (int k = 0; k < count; ++k) {
+                    inputData[k].reset(new InputData(lengths[k], csvData._p, csvData._q));
+                    genLpLqFuncs(lengths[k], inputData[k].get(), true);
+                    problems[k] = inputData[k].get();
+                    totalN += lengths[k];
+                }
+
+                // A fresh OutputData per problem, solved one by one.
+                std::vector<std::vector<data_type>> serial_x(count);
+                auto start = std::chrono::steady_clock::now();
+                for (int k = 0; k < count; ++k) {
+                    OutputData outputData(*problems[k]);
+                    kktSolver.solveAuto(*problems[k], &outputData);
+                    serial_x[k].assign(outputData._x, outputData._x + lengths[k]);
+                }
+                auto end = std::chrono::steady_clock::now();
+                runTimes[0][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete Serial in round " << iter
+                    << " in time " << runTimes[0][iter] << " ms\n";
+
+                // One worker: the workspace reuse alone.
+                std::vector<std::vector<data_type>> batch1_x;
+                start = std::chrono::steady_clock::now();
+                kktSolver.solveBatch(problems, &batch1_x, 1);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete Batch-1 in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (batchMaxDiff(serial_x, batch1_x) >= SOL_ESP) {
+                    std::cout << "Batch-1 solution is invalid!\n";
+                }
+
+                std::vector<std::vector<data_type>> batch_x;
+                start = std::chrono::steady_clock::now();
+                kktSolver.solveBatch(problems, &batch_x, numThreads, true);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete Batch in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (batchMaxDiff(serial_x, batch_x) >= SOL_ESP) {
+                    std::cout << "Batch solution is invalid!\n";
+                }
+
+                std::cout << "****\n";
+            }
+            for (int j = 0; j < algNum; ++j) {
+                double aveTime, stdTime;
+                stat(runTimes[j], &aveTime, &stdTime);
+                csvData._figures[j * 2][i] = aveTime;
+                csvData._figures[j * 2 + 1][i] = stdTime;
+                // Throughput at the average time.
+                std::cout << cpAlgsList[j] << ": "
+                    << count * 1000.0 / std::max(aveTime, 1.0) << " problems/s\n";
+            }
+            std::cout << "Total nodes in the last round: " << totalN << "\n";
+            std::cout << "===========\n";
+        }
+        std::string filename = path + "/out_" + toString(csvData._problemType)
+            + "-l" + std::to_string(csvData._p) + "-l" + std::to_string(csvData._q)
+            + "_" + toString(csvData._genDataType) + ".txt";
+        csvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
+}
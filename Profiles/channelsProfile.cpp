@@ -0,0 +1,118 @@
+//
+//  channelsProfile.cpp
+//  KKT
+//
+
+#include "comparison_profiles.hpp"
+#include <iostream>
+#include <memory>
+#include <thread>
+
+// Signals of up to 10^CHANNELS_MAX_SCALES nodes per channel.
+const int CHANNELS_MAX_SCALES = 5;
+
+// Per-channel throughput of equal-length l2-l1 channels: the scalar loop of
+// fast_l2_l1 over the channels against solveBatch (the engine of solveAuto
+// per channel) on one worker and on all cores. A channel-minor lockstep
+// variant of fast_l2_l1 that ran 4 or 8 channels per lane group was about 3x
+// slower than the scalar loop here at every n, and was dropped.
+void channelsProfile(int rounds, const std::string& path) {
+    assert(rounds > 0);
+    std::vector<std::vector<time_ms_type>> runTimes;
+    CSV csvData;
+    csvData._problemType = CHANNELS;
+    csvData._genDataType = KKT_LP_LQ;
+    csvData._p = 2;
+    csvData._q = 1;
+    int numScales = std::min(NUM_SCALES, CHANNELS_MAX_SCALES);
+    size_t algNum = cpAlgs[csvData._problemType].size();
+    const std::vector<std::string>& cpAlgsList = cpAlgs[csvData._problemType];
+    csvData.init(cpAlgsList, numScales);
+    for (int i = 0; i < algNum; ++i) {
+        runTimes.push_back(std::vector<time_ms_type>(rounds, 0));
+    }
+    int numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    int n;
+
+    // Case 1: 8 channels sharing _cSep; Case 2: 64 channels, own _cSep.
+    for (int shared = 1; shared >= 0; --shared) {
+        int channels = shared ? 8 : 64;
+        std::cout << "Run " << toString(csvData._problemType) << " with data "
+            << toString(csvData._genDataType) << " for l2-l1 on " << channels
+            << " channels" << (shared ? " sharing separations" : "")
+            << ", varying n, " << numThreads << " threads" << std::endl;
+        n = 1;
+        for (int i = 0; i < numScales; ++i) {
+            n *= 10;
+            csvData._colTitles[i] = n;
+            csvData._n = n;
+            std::cout << "n = " << n << std::endl;
+            for (int iter = 0; iter < rounds; ++iter) {
+                std::vector<std::unique_ptr<InputData>> inputData(channels);
+                std::vector<std::unique_ptr<OutputData>> fast_outputData(channels);
+                std::vector<const InputData*> problems(channels);
+                for (int c = 0; c < channels; ++c) {
+                    inputData[c].reset(new InputData(n, csvData._p, csvData._q));
+                    genLpLqFuncs(n, inputData[c].get(), true);
+                    if (shared) {
+                        std::copy(inputData[0]->_cSep, inputData[0]->_cSep + n - 1,
+                                  inputData[c]->_cSep);
+                    }
+                    fast_outputData[c].reset(new OutputData(*inputData[c]));
+                    problems[c] = inputData[c].get();
+                }
+
+                // Function call to the scalar loop over the channels.
+                auto start = std::chrono::steady_clock::now();
+                for (int c = 0; c < channels; ++c) {
+                    kktSolver.fast_l2_l1(*inputData[c], fast_outputData[c].get());
+                }
+                auto end = std::chrono::steady_clock::now();
+                runTimes[0][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Fast in round " << iter
+                    << " in time " << runTimes[0][iter] << " ms\n";
+
+                const int threadCounts[] = {1, numThreads};
+                for (int b = 0; b < 2; ++b) {
+                    std::vector<std::vector<data_type>> batch_x;
+                    start = std::chrono::steady_clock::now();
+                    kktSolver.solveBatch(problems, &batch_x, threadCounts[b]);
+                    end = std::chrono::steady_clock::now();
+                    runTimes[b + 1][iter] = std::chrono::duration_cast
+                        <std::chrono::milliseconds>(end - start).count();
+                    std::cout << "Complete " << cpAlgsList[b + 1] << " in round "
+                        << iter << " in time " << runTimes[b + 1][iter] << " ms\n";
+                    bool valid = true;
+                    for (int c = 0; c < channels && valid; ++c) {
+                        OutputData batch_outputData(*inputData[c]);
+                        std::copy(batch_x[c].begin(), batch_x[c].end(),
+                                  batch_outputData._x);
+                        valid = solValid(*inputData[c], fast_outputData[c].get(),
+                                         &batch_outputData);
+                    }
+                    if (!valid) {
+                        std::cout << cpAlgsList[b + 1] << " solution is invalid!\n";
+                    }
+                }
+
+                std::cout << "****\n";
+            }
+            for (int j = 0; j < algNum; ++j) {
+                double aveTime, stdTime;
+                stat(runTimes[j], &aveTime, &stdTime);
+                csvData._figures[j * 2][i] = aveTime;
+                csvData._figures[j * 2 + 1][i] = stdTime;
+                std::cout << cpAlgsList[j] << ": " << aveTime / channels
+                    << " ms per channel\n";
+            }
+            std::cout << "===========\n";
+        }
+        std::string filename = path + "/out_" + toString(csvData._problemType)
+            + "-" + std::to_string(channels) + (shared ? "-shared" : "") + "_"
+            + toString(csvData._genDataType) + ".txt";
+        csvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
+}
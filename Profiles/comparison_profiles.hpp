@@ -11,6 +11,8 @@
 #ifndef comparison_profiles_hpp
 #define comparison_profiles_hpp
 
+#include <chrono>
+#include <cmath>
 #include "data_generator.hpp"
 #include <string>
 #include <vector>
@@ -45,6 +47,16 @@ typedef enum PROBLEM_TYPE {
     LP_LQ,
     LINEAR_L2,
     HUBER,
+    ISOTONIC,
+    TREE,
+    TV_ND,
+    RESOLVE,
+    STREAM,
+    SLIDING,
+    BATCH,
+    CHANNELS,
+    SMALL,
+    WORKSPACE,
 } problem_type;
 
 // Map from problem type to string for output.
@@ -62,6 +74,16 @@ void pwl2Profile(int rounds, const std::string& path);
 void lplqProfile(int rounds, const std::string& path);
 void linearl2Profile(int rounds, const std::string& path);
 void huberProfile(int rounds, const std::string& path);
+void isotonicProfile(int rounds, const std::string& path);
+void treeProfile(int rounds, const std::string& path);
+void tvndProfile(int rounds, const std::string& path);
+void resolveProfile(int rounds, const std::string& path);
+void streamProfile(int rounds, const std::string& path);
+void slidingProfile(int rounds, const std::string& path);
+void batchProfile(int rounds, const std::string& path);
+void channelsProfile(int rounds, const std::string& path);
+void smallProfile(int rounds, const std::string& path);
+void workspaceProfile(int rounds, const std::string& path);
 
 // Utility functions
 template <typename T>
@@ -87,6 +109,14 @@ void stat(const std::vector<T>& runTimes,
 
 bool solValid(const InputData& inputData, OutputData* kkt_outputData,
               OutputData* outputData);
+// Objective check for inputs whose minimizer need not be unique (e.g. tied
+// breakpoints): whether ${outputData} is within OBJ_ESP of the reference.
+bool objValid(const InputData& inputData, OutputData* ref_outputData,
+              OutputData* outputData);
+// Heap allocations (malloc, calloc, realloc, posix_memalign, and operator new)
+// made so far on the calling thread; -1 where the allocator is not counted
+// (non-glibc builds).
+long long numHeapAllocations();
 
 //////////////////////////////////////////////////////
 // Data structure to write to csv.
@@ -110,4 +140,18 @@ struct CSV {
     }
 };
 
+// Lambda sweep on one input: _cSep scaled by the lambdas of the varying-lambda
+// cases (INIT_LAMBDA * 10^i), by independent solve() calls ("KKT") and by
+// solveSweep ("KKT-Sweep"). Fills ${csvData} with the per-lambda times and
+// prints the total sweep times.
+void lambdaSweepProfile(InputData* inputData, int rounds, CSV* csvData);
+
+// Strong scaling on one input of SCALING_N nodes: single-threaded solveAuto()
+// ("KKT-Auto", the engine each block runs) against solveParallel ("KKT-DD")
+// on 1, 2, 4, ..., SCALING_MAX_THREADS threads, so that the ratio is the
+// parallel speedup only. Fills ${csvData} with the times per thread count.
+const int SCALING_N = 1000000;
+const int SCALING_MAX_THREADS = 8;
+void strongScalingProfile(const InputData& inputData, int rounds, CSV* csvData);
+
 #endif /* comparison_profiles_hpp */
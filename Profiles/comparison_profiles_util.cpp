@@ -6,6 +6,7 @@
 //  Copyright © 2020 Cheng Lu. All rights reserved.
 //
 
+#include <cerrno>
 #include <chrono>
 #include <cmath>
 #include "comparison_profiles.hpp"
@@ -19,18 +20,75 @@
 // Global KKT solver.
 KKTSolver kktSolver;
 
+#if defined(__GLIBC__)
+// Heap allocations counted per thread: malloc and friends of the executable
+// interpose the ones of glibc (operator new goes through malloc) and forward
+// to its __libc_* entry points.
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t num, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+}
+
+static thread_local long long heapAllocations = 0;
+
+extern "C" void* malloc(size_t size) {
+    ++heapAllocations;
+    return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t num, size_t size) {
+    ++heapAllocations;
+    return __libc_calloc(num, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) {
+    ++heapAllocations;
+    return __libc_realloc(ptr, size);
+}
+
+extern "C" int posix_memalign(void** ptr, size_t alignment, size_t size) {
+    ++heapAllocations;
+    void* p = __libc_memalign(alignment, size);
+    if (p == NULL) {
+        return ENOMEM;
+    }
+    *ptr = p;
+    return 0;
+}
+
+long long numHeapAllocations() {
+    return heapAllocations;
+}
+#else
+long long numHeapAllocations() {
+    return -1;
+}
+#endif
+
 // List of methods to compare for each problem type.
 std::vector<std::vector<std::string>> cpAlgs = {
-    {"KKT"}, //"Kolmogorov", "Kolmogorov-nloglogn"},
-    {"KKT"}, //"Projected Newton", "Linearized Taut String", "Classic Taut String",
-        //"Hybrid Taut String", "Condat", "Condat's Taut String", "Johnson", "Kolmogorov"},
-    {"KKT"}, //"Projected Newton", "Taut String", "Kolmogorov"},
-    {"KKT"}, //"Thomas Algorithm"},
-    {"KKT"}, //"Kolmogorov", "Kolmogorov-nloglogn"},
-    {"KKT"}, //"Kolmogorov"},
-    {"KKT"}, //"ceres", "nlopt", "dlib"},
-    {"KKT"},
+    {"KKT", "KKT-Fast", "DP"}, //"Kolmogorov-nloglogn"},
+    {"KKT", "Condat", "Taut String", "Path", "Path-Query"}, //"Projected Newton", "Linearized Taut String",
+        //"Hybrid Taut String", "Condat's Taut String", "Johnson", "Kolmogorov"},
+    {"KKT", "Taut String"}, //"Projected Newton", "Kolmogorov"},
+    {"KKT", "KKT-Thomas", "KKT-Thomas-Parallel", "KKT-Bidirectional"},
+    {"KKT", "KKT-Fast", "DP"}, //"Kolmogorov-nloglogn"},
+    {"KKT", "KKT-Fast", "DP"},
     {"KKT"}, //"ceres", "nlopt", "dlib"},
+    {"KKT", "KKT-Parallel"},
+    {"KKT", "KKT-Fast", "KKT-Bidirectional"}, //"ceres", "nlopt", "dlib"},
+    {"KKT", "PAV"},
+    {"KKT", "Tree-Chain", "Tree-Random", "Tree-Caterpillar"},
+    {"KKT-PerLine", "Lines-Parallel", "TV-Prox"},
+    {"KKT", "KKT-Resolve"},
+    {"DP", "Stream"},
+    {"Copy-Solve", "Sliding"},
+    {"Serial", "Batch-1", "Batch"},
+    {"KKT-Fast", "Batch-1", "Batch"},
+    {"KKT-Fast", "KKT-Small", "KKT-Small-Fixed"},
+    {"Fresh", "Workspace"},
 };
 
 // Tuning parameters fed from command line.
@@ -64,6 +122,16 @@ std::string toString(problem_type problemType) {
         case LP_LQ: return "LP-LQ";
         case LINEAR_L2: return "Linear-L2";
         case HUBER: return "Huber";
+        case ISOTONIC: return "Isotonic";
+        case TREE: return "Tree";
+        case TV_ND: return "TV-ND";
+        case RESOLVE: return "Resolve";
+        case STREAM: return "Stream";
+        case SLIDING: return "Sliding";
+        case BATCH: return "Batch";
+        case CHANNELS: return "Channels";
+        case SMALL: return "Small";
+        case WORKSPACE: return "Workspace";
         default:
             return "";
     }
@@ -90,6 +158,133 @@ bool solValid(const InputData& inputData, OutputData* kkt_outputData,
     return b1 || b2;
 }
 
+bool objValid(const InputData& inputData, OutputData* ref_outputData,
+              OutputData* outputData) {
+    kktSolver.compObj(inputData, ref_outputData);
+    kktSolver.compObj(inputData, outputData);
+    if (outputData->_objVal - ref_outputData->_objVal < OBJ_ESP) {
+        return true;
+    }
+    std::cout << "ref obj = " << ref_outputData->_objVal << "; other obj = "
+        << outputData->_objVal << std::endl;
+    return false;
+}
+
+void lambdaSweepProfile(InputData* inputData, int rounds, CSV* csvData) {
+    assert(inputData != NULL && rounds > 0 && csvData != NULL);
+    int numScales = NUM_SCALES;
+    std::vector<std::string> algs = {"KKT", "KKT-Sweep"};
+    csvData->init(algs, numScales);
+    std::vector<data_type> scales(numScales);
+    data_type lambda = INIT_LAMBDA;
+    for (int i = 0; i < numScales; ++i) {
+        lambda *= 10;
+        scales[i] = lambda;
+        csvData->_colTitles[i] = lambda;
+    }
+    // runTimes[alg][scale][round]
+    std::vector<std::vector<std::vector<time_ms_type>>> runTimes(algs.size(),
+        std::vector<std::vector<time_ms_type>>(numScales, std::vector<time_ms_type>(rounds, 0)));
+    for (int iter = 0; iter < rounds; ++iter) {
+        time_ms_type totalTimes[2] = {0, 0};
+        auto start = std::chrono::steady_clock::now();
+        // The independent solve of each lambda runs on the scaled input handed
+        // to the callback, outside the sweep's clock.
+        kktSolver.solveSweep(inputData, scales, [&](int k, const InputData& scaledData,
+                                                    const OutputData& sweep_outputData) {
+            auto end = std::chrono::steady_clock::now();
+            runTimes[1][k][iter] = std::chrono::duration_cast
+                <std::chrono::milliseconds>(end - start).count();
+            OutputData kkt_outputData(scaledData);
+            start = std::chrono::steady_clock::now();
+            kktSolver.solve(scaledData, &kkt_outputData);
+            end = std::chrono::steady_clock::now();
+            runTimes[0][k][iter] = std::chrono::duration_cast
+                <std::chrono::milliseconds>(end - start).count();
+            std::cout << "lambda = " << scales[k] << ": KKT " << runTimes[0][k][iter]
+                << " ms, KKT-Sweep " << runTimes[1][k][iter] << " ms\n";
+            OutputData sweep_copy;
+            sweep_copy = sweep_outputData;
+            if (!solValid(scaledData, &kkt_outputData, &sweep_copy)) {
+                std::cout << "KKT-Sweep solution is invalid!\n";
+            }
+            totalTimes[0] += runTimes[0][k][iter];
+            totalTimes[1] += runTimes[1][k][iter];
+            start = std::chrono::steady_clock::now();
+        });
+        std::cout << "Complete the sweep in round " << iter << ": KKT "
+            << totalTimes[0] << " ms, KKT-Sweep " << totalTimes[1] << " ms in total\n";
+        std::cout << "****\n";
+    }
+    for (int j = 0; j < algs.size(); ++j) {
+        for (int i = 0; i < numScales; ++i) {
+            double aveTime, stdTime;
+            stat(runTimes[j][i], &aveTime, &stdTime);
+            csvData->_figures[j * 2][i] = aveTime;
+            csvData->_figures[j * 2 + 1][i] = stdTime;
+        }
+    }
+}
+
+void strongScalingProfile(const InputData& inputData, int rounds, CSV* csvData) {
+    assert(rounds > 0 && csvData != NULL);
+    std::vector<int> threadCounts;
+    for (int t = 1; t <= SCALING_MAX_THREADS; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    int numScales = (int)threadCounts.size();
+    std::vector<std::string> algs = {"KKT-Auto", "KKT-DD"};
+    csvData->init(algs, numScales);
+    for (int i = 0; i < numScales; ++i) {
+        csvData->_colTitles[i] = threadCounts[i];
+    }
+    // runTimes[alg][thread count][round]
+    std::vector<std::vector<std::vector<time_ms_type>>> runTimes(algs.size(),
+        std::vector<std::vector<time_ms_type>>(numScales, std::vector<time_ms_type>(rounds, 0)));
+    // Reference solution, untimed.
+    OutputData ref_outputData(inputData);
+    kktSolver.solve(inputData, &ref_outputData);
+    for (int iter = 0; iter < rounds; ++iter) {
+        OutputData kkt_outputData(inputData);
+        // Function call to the serial engine of the blocks
+        auto start = std::chrono::steady_clock::now();
+        kktSolver.solveAuto(inputData, &kkt_outputData, 1);
+        auto end = std::chrono::steady_clock::now();
+        time_ms_type kktTime = std::chrono::duration_cast
+            <std::chrono::milliseconds>(end - start).count();
+        std::cout << "Complete KKT-Auto (" << toString(kkt_outputData._engine)
+            << ") in round " << iter << " in time " << kktTime << " ms\n";
+        if (!solValid(inputData, &ref_outputData, &kkt_outputData)) {
+            std::cout << "KKT-Auto solution is invalid!\n";
+        }
+        for (int i = 0; i < numScales; ++i) {
+            runTimes[0][i][iter] = kktTime;
+            OutputData dd_outputData(inputData);
+            start = std::chrono::steady_clock::now();
+            kktSolver.solveParallel(inputData, &dd_outputData, threadCounts[i]);
+            end = std::chrono::steady_clock::now();
+            runTimes[1][i][iter] = std::chrono::duration_cast
+                <std::chrono::milliseconds>(end - start).count();
+            std::cout << "Complete KKT-DD on " << threadCounts[i] << " threads in round "
+                << iter << " in time " << runTimes[1][i][iter] << " ms (speedup "
+                << kktTime * 1.0 / std::max(runTimes[1][i][iter], (time_ms_type)1)
+                << "x)\n";
+            if (!solValid(inputData, &ref_outputData, &dd_outputData)) {
+                std::cout << "KKT-DD solution is invalid!\n";
+            }
+        }
+        std::cout << "****\n";
+    }
+    for (int j = 0; j < algs.size(); ++j) {
+        for (int i = 0; i < numScales; ++i) {
+            double aveTime, stdTime;
+            stat(runTimes[j][i], &aveTime, &stdTime);
+            csvData->_figures[j * 2][i] = aveTime;
+            csvData->_figures[j * 2 + 1][i] = stdTime;
+        }
+    }
+}
+
 void CSV::init(const std::vector<std::string>& cpAlgsList, int numScales) {
     assert(!cpAlgsList.empty() && numScales > 0);
     _colTitles.resize(numScales);
@@ -75,6 +75,32 @@ void huberProfile(int rounds, const std::string& path) {
                     << " with objective value = " << kkt_outputData._objVal
                     << "\n";
 
+                // Fast KKT
+                OutputData fast_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_huber_l1(inputData, &fast_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Fast in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &fast_outputData)) {
+                    std::cout << "KKT-Fast solution is invalid!\n";
+                }
+
+                // Forward and backward sweeps meeting in the middle
+                OutputData bidi_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.solveBidirectional(inputData, &bidi_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Bidirectional in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &bidi_outputData)) {
+                    std::cout << "KKT-Bidirectional solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -141,6 +167,32 @@ void huberProfile(int rounds, const std::string& path) {
                     << " with objective value = " << kkt_outputData._objVal
                     << "\n";
 
+                // Fast KKT
+                OutputData fast_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_l2_huber(inputData, &fast_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Fast in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &fast_outputData)) {
+                    std::cout << "KKT-Fast solution is invalid!\n";
+                }
+
+                // Forward and backward sweeps meeting in the middle
+                OutputData bidi_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.solveBidirectional(inputData, &bidi_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Bidirectional in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &bidi_outputData)) {
+                    std::cout << "KKT-Bidirectional solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -165,4 +217,33 @@ void huberProfile(int rounds, const std::string& path) {
         std::cout << "Written in file " << filename << std::endl;
         std::cout << "////////////////////\n";
     }
+
+    // Case 3: Strong scaling of the domain decomposition at fixed n, Huber-l1.
+    {
+        CSV scalingCsvData;
+        scalingCsvData._problemType = HUBER;
+        scalingCsvData._genDataType = KKT_HUBER;
+        scalingCsvData._p = 2;
+        scalingCsvData._q = 1;
+        n = SCALING_N;
+        scalingCsvData._n = n;
+        std::cout << "Run " << toString(scalingCsvData._problemType) << " with data "
+            << toString(scalingCsvData._genDataType) << " for Huber-l1, n = " << n
+            << " and varying threads" << std::endl;
+        InputData inputData(n, 2, 1, InputData::HUBER_D, InputData::LQ);
+        genLpLqFuncs(n, &inputData);
+        std::vector<data_type> baselines(n, 0);
+        for (int i = 0; i < n; ++i) {
+            baselines[i] = fabs(inputData._aDev[i]);
+        }
+        genHuberFuncs(n, baselines, &inputData, true);
+        inputData._lb = -1;
+        inputData._ub = 1;
+        strongScalingProfile(inputData, rounds, &scalingCsvData);
+        std::string filename = path + "/out_" + toString(scalingCsvData._problemType)
+            + "-l1_" + toString(scalingCsvData._genDataType) + "-SCALING.txt";
+        scalingCsvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
 }
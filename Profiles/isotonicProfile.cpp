@@ -0,0 +1,98 @@
+//
+//  isotonicProfile.cpp
+//  KKT
+//
+
+#include "comparison_profiles.hpp"
+#include <iostream>
+
+// Largest n on which the bisection KKT runs; it is super-linear on isotonic
+// inputs (about 4 s at n = 1e5).
+const int ISOTONIC_KKT_MAX_N = 100000;
+
+void isotonicProfile(int rounds, const std::string& path) {
+    assert(rounds > 0);
+    std::vector<std::vector<time_ms_type>> runTimes;
+    CSV csvData;
+    csvData._problemType = ISOTONIC;
+    csvData._genDataType = KKT_ISOTONIC;
+    csvData._q = 1;
+    int numScales = NUM_SCALES;
+    size_t algNum = cpAlgs[csvData._problemType].size();
+    const std::vector<std::string>& cpAlgsList = cpAlgs[csvData._problemType];
+    csvData.init(cpAlgsList, numScales);
+    for (int i = 0; i < algNum; ++i) {
+        runTimes.push_back(std::vector<time_ms_type>(rounds, 0));
+    }
+    int n;
+
+    // Case 1: l2 deviations; Case 2: Huber deviations.
+    std::vector<InputData::deviation_type> deviationTypes = {InputData::LP, InputData::HUBER_D};
+    for (int dvIndex = 0; dvIndex < deviationTypes.size(); ++dvIndex) {
+        InputData::deviation_type deviationType = deviationTypes[dvIndex];
+        std::string deviationName = deviationType == InputData::LP ? "l2" : "Huber";
+        csvData._p = 2;
+        std::cout << "Run " << toString(csvData._problemType) << " with data "
+            << toString(csvData._genDataType)
+            << " for " << deviationName << "-l1 and varying n" << std::endl;
+        n = 1;
+        for (int i = 0; i < numScales; ++i) {
+            n *= 10;
+            csvData._colTitles[i] = n;
+            csvData._n = n;
+            std::cout << "n = " << n << std::endl;
+            for (int iter = 0; iter < rounds; ++iter) {
+                InputData inputData(n, csvData._p, csvData._q, deviationType, InputData::LQ);
+                genIsotonicFuncs(n, &inputData);
+                if (deviationType == InputData::HUBER_D) {
+                    std::vector<data_type> baselines(n, ISOTONIC_NOISE);
+                    genHuberFuncs(n, baselines, &inputData, true);
+                }
+                inputData._lb = -3;
+                inputData._ub = 3;
+
+                OutputData kkt_outputData(inputData);
+                bool kktRun = n <= ISOTONIC_KKT_MAX_N;
+                if (kktRun) {
+                    // Function call to KKT
+                    auto start = std::chrono::steady_clock::now();
+                    kktSolver.solve(inputData, &kkt_outputData);
+                    auto end = std::chrono::steady_clock::now();
+                    runTimes[0][iter] = std::chrono::duration_cast
+                        <std::chrono::milliseconds>(end - start).count();
+                    std::cout << "Complete KKT in round " << iter
+                        << " in time " << runTimes[0][iter] << " ms\n";
+                } else {
+                    std::cout << "Skip KKT for n = " << n << std::endl;
+                }
+
+                OutputData pav_outputData(inputData);
+                // Function call to PAV
+                auto start = std::chrono::steady_clock::now();
+                kktSolver.pav_solve(inputData, &pav_outputData);
+                auto end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete PAV in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (kktRun && !solValid(inputData, &kkt_outputData, &pav_outputData)) {
+                    std::cout << "PAV solution is invalid!\n";
+                }
+
+                std::cout << "****\n";
+            }
+            for (int j = 0; j < algNum; ++j) {
+                double aveTime, stdTime;
+                stat(runTimes[j], &aveTime, &stdTime);
+                csvData._figures[j * 2][i] = aveTime;
+                csvData._figures[j * 2 + 1][i] = stdTime;
+            }
+            std::cout << "===========\n";
+        }
+        std::string filename = path + "/out_" + toString(csvData._problemType)
+            + "-" + deviationName + "_" + toString(csvData._genDataType) + ".txt";
+        csvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
+}
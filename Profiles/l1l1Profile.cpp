@@ -9,6 +9,12 @@
 #include "comparison_profiles.hpp"
 #include <iostream>
 
+// Tied inputs: TIE_CASES problems of TIE_N nodes with cDev, aDev and cSep on
+// a grid of TIE_STEP.
+const int TIE_CASES = 10000;
+const int TIE_N = 10;
+const data_type TIE_STEP = 0.25;
+
 void l1l1Profile(int rounds, const std::string& path) {
     assert(rounds > 0);
     std::vector<std::vector<time_ms_type>> runTimes;
@@ -66,6 +72,32 @@ void l1l1Profile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                OutputData fast_outputData(inputData);
+                // Function call to fast KKT
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_l1_l1(inputData, &fast_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Fast in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &fast_outputData)) {
+                    std::cout << "KKT-Fast solution is invalid!\n";
+                }
+
+                OutputData dp_outputData(inputData);
+                // Function call to the DP solver
+                start = std::chrono::steady_clock::now();
+                kktSolver.dp_solve(inputData, &dp_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete DP in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &dp_outputData)) {
+                    std::cout << "DP solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -74,6 +106,10 @@ void l1l1Profile(int rounds, const std::string& path) {
                 csvData._figures[j * 2][i] = aveTime;
                 csvData._figures[j * 2 + 1][i] = stdTime;
             }
+            if (csvData._figures[2][i] > 0) {
+                std::cout << "Speedup of KKT-Fast over KKT: "
+                    << csvData._figures[0][i] / csvData._figures[2][i] << "x\n";
+            }
             std::cout << "===========\n";
         }
         std::string filename = path + "/out_" + toString(csvData._problemType)
@@ -125,6 +161,32 @@ void l1l1Profile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                OutputData fast_outputData(inputData);
+                // Function call to fast KKT
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_l1_l1(inputData, &fast_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Fast in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &fast_outputData)) {
+                    std::cout << "KKT-Fast solution is invalid!\n";
+                }
+
+                OutputData dp_outputData(inputData);
+                // Function call to the DP solver
+                start = std::chrono::steady_clock::now();
+                kktSolver.dp_solve(inputData, &dp_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete DP in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &dp_outputData)) {
+                    std::cout << "DP solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -133,6 +195,10 @@ void l1l1Profile(int rounds, const std::string& path) {
                 csvData._figures[j * 2][i] = aveTime;
                 csvData._figures[j * 2 + 1][i] = stdTime;
             }
+            if (csvData._figures[2][i] > 0) {
+                std::cout << "Speedup of KKT-Fast over KKT: "
+                    << csvData._figures[0][i] / csvData._figures[2][i] << "x\n";
+            }
             std::cout << "===========\n";
         }
         std::string filename = path + "/out_" + toString(csvData._problemType)
@@ -141,4 +207,35 @@ void l1l1Profile(int rounds, const std::string& path) {
         std::cout << "Written in file " << filename << std::endl;
         std::cout << "////////////////////\n";
     }
+
+    // Case 3: Tied breakpoints, where the minimizer need not be unique;
+    // objectives are checked against DP.
+    std::cout << "Run " << toString(csvData._problemType) << " with data "
+        << toString(KKT_LP_LQ) << " on a grid of " << TIE_STEP << " for "
+        << TIE_CASES << " inputs of n = " << TIE_N << std::endl;
+    for (int iter = 0; iter < rounds; ++iter) {
+        int numInvalid = 0;
+        for (int k = 0; k < TIE_CASES; ++k) {
+            InputData inputData(TIE_N, 1, 1);
+            genLpLqFuncs(TIE_N, &inputData);
+            quantize(TIE_N, TIE_STEP, inputData._cDev);
+            quantize(TIE_N, TIE_STEP, inputData._aDev);
+            quantize(TIE_N - 1, TIE_STEP, inputData._cSep);
+            inputData._lb = -1;
+            inputData._ub = 1;
+            OutputData fast_outputData(inputData);
+            kktSolver.fast_l1_l1(inputData, &fast_outputData);
+            OutputData dp_outputData(inputData);
+            kktSolver.dp_solve(inputData, &dp_outputData);
+            if (!objValid(inputData, &dp_outputData, &fast_outputData)) {
+                ++numInvalid;
+            }
+        }
+        std::cout << "Complete tied inputs in round " << iter << ": "
+            << numInvalid << " of " << TIE_CASES << " invalid\n";
+        if (numInvalid > 0) {
+            std::cout << "KKT-Fast solution is invalid!\n";
+        }
+    }
+    std::cout << "////////////////////\n";
 }
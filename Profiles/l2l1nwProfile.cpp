@@ -9,6 +9,9 @@
 #include "comparison_profiles.hpp"
 #include <iostream>
 
+// Largest n on which Condat runs for CONDAT_WORST_CASE.
+const int CONDAT_WORST_CASE_MAX_N = 100000;
+
 void l2l1nwProfile(int rounds, const std::string& path) {
     assert(rounds > 0);
     std::vector<std::vector<time_ms_type>> runTimes;
@@ -64,6 +67,56 @@ void l2l1nwProfile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                // Condat's algorithm is quadratic on its worst-case input.
+                if (csvData._genDataType != CONDAT_WORST_CASE ||
+                    n <= CONDAT_WORST_CASE_MAX_N) {
+                    OutputData condat_outputData(inputData);
+                    start = std::chrono::steady_clock::now();
+                    kktSolver.condat_l2_l1(inputData, &condat_outputData);
+                    end = std::chrono::steady_clock::now();
+                    runTimes[1][iter] = std::chrono::duration_cast
+                        <std::chrono::milliseconds>(end - start).count();
+                    std::cout << "Complete Condat in round " << iter
+                        << " in time " << runTimes[1][iter] << " ms\n";
+                    if (!solValid(inputData, &kkt_outputData, &condat_outputData)) {
+                        std::cout << "Condat solution is invalid!\n";
+                    }
+                } else {
+                    std::cout << "Skip Condat for n = " << n << std::endl;
+                }
+
+                OutputData taut_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.taut_string_l2_l1(inputData, &taut_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete Taut String in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &taut_outputData)) {
+                    std::cout << "Taut String solution is invalid!\n";
+                }
+
+                // The path is built once for all lambdas; Path-Query is the
+                // cost of each further lambda.
+                L2L1Path l2l1Path;
+                OutputData path_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.l2_l1_path(inputData, &l2l1Path);
+                auto queryStart = std::chrono::steady_clock::now();
+                l2l1Path.solution(inputData._cSep[0], &path_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[3][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                runTimes[4][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - queryStart).count();
+                std::cout << "Complete Path in round " << iter
+                    << " in time " << runTimes[3][iter] << " ms (query "
+                    << runTimes[4][iter] << " ms)\n";
+                if (!solValid(inputData, &kkt_outputData, &path_outputData)) {
+                    std::cout << "Path solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -121,6 +174,50 @@ void l2l1nwProfile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                OutputData condat_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.condat_l2_l1(inputData, &condat_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete Condat in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &condat_outputData)) {
+                    std::cout << "Condat solution is invalid!\n";
+                }
+
+                OutputData taut_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.taut_string_l2_l1(inputData, &taut_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete Taut String in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &taut_outputData)) {
+                    std::cout << "Taut String solution is invalid!\n";
+                }
+
+                // The path is built once for all lambdas; Path-Query is the
+                // cost of each further lambda.
+                L2L1Path l2l1Path;
+                OutputData path_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.l2_l1_path(inputData, &l2l1Path);
+                auto queryStart = std::chrono::steady_clock::now();
+                l2l1Path.solution(inputData._cSep[0], &path_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[3][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                runTimes[4][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - queryStart).count();
+                std::cout << "Complete Path in round " << iter
+                    << " in time " << runTimes[3][iter] << " ms (query "
+                    << runTimes[4][iter] << " ms)\n";
+                if (!solValid(inputData, &kkt_outputData, &path_outputData)) {
+                    std::cout << "Path solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
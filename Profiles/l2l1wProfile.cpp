@@ -65,6 +65,18 @@ void l2l1wProfile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                OutputData taut_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.taut_string_l2_l1(inputData, &taut_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete Taut String in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &taut_outputData)) {
+                    std::cout << "Taut String solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -123,6 +135,18 @@ void l2l1wProfile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                OutputData taut_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.taut_string_l2_l1(inputData, &taut_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete Taut String in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &taut_outputData)) {
+                    std::cout << "Taut String solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -139,4 +163,25 @@ void l2l1wProfile(int rounds, const std::string& path) {
         std::cout << "Written in file " << filename << std::endl;
         std::cout << "////////////////////\n";
     }
+
+    // Case 3: Fix input size and weights, sweep lambda.
+    {
+        csvData._genDataType = MPO_W_LAMBDA;
+        std::cout << "Run " << toString(csvData._problemType) << " with data "
+            << toString(csvData._genDataType)
+            << " for a warm-started lambda sweep" << std::endl;
+        n = FIX_N;
+        csvData._n = n;
+        // Unit-mean weights, scaled by each lambda.
+        InputData inputData(n, 2, 1);
+        genLpLqFuncs(n, &inputData, csvData._genDataType, 1);
+        inputData._lb = -2;
+        inputData._ub = 2;
+        lambdaSweepProfile(&inputData, rounds, &csvData);
+        std::string filename = path + "/out_" + toString(csvData._problemType)
+            + "_" + toString(csvData._genDataType) + "-SWEEP.txt";
+        csvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
 }
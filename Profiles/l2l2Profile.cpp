@@ -6,8 +6,10 @@
 //  Copyright © 2020 Cheng Lu. All rights reserved.
 //
 
+#include <algorithm>
 #include "comparison_profiles.hpp"
 #include <iostream>
+#include <thread>
 
 void l2l2Profile(int rounds, const std::string& path) {
     assert(rounds > 0);
@@ -25,6 +27,8 @@ void l2l2Profile(int rounds, const std::string& path) {
         runTimes.push_back(std::vector<time_ms_type>(rounds, 0));
     }
     int n;
+    int numThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "Threads for KKT-Thomas-Parallel: " << numThreads << std::endl;
 
     // Case 1: Varying input sizes.
     std::vector<gen_data_type> inputSizeDataType = {KKT_LP_LQ};
@@ -65,6 +69,46 @@ void l2l2Profile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                // Direct tridiagonal solve
+                OutputData thomas_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_l2_l2(inputData, &thomas_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Thomas in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &thomas_outputData)) {
+                    std::cout << "KKT-Thomas solution is invalid!\n";
+                }
+
+                // Partitioned tridiagonal solve
+                OutputData parallel_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_l2_l2_parallel(inputData, &parallel_outputData,
+                                              numThreads);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Thomas-Parallel in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &parallel_outputData)) {
+                    std::cout << "KKT-Thomas-Parallel solution is invalid!\n";
+                }
+
+                // Forward and backward sweeps meeting in the middle
+                OutputData bidi_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.solveBidirectional(inputData, &bidi_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[3][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Bidirectional in round " << iter
+                    << " in time " << runTimes[3][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &bidi_outputData)) {
+                    std::cout << "KKT-Bidirectional solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -123,6 +167,46 @@ void l2l2Profile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                // Direct tridiagonal solve
+                OutputData thomas_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_l2_l2(inputData, &thomas_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Thomas in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &thomas_outputData)) {
+                    std::cout << "KKT-Thomas solution is invalid!\n";
+                }
+
+                // Partitioned tridiagonal solve
+                OutputData parallel_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_l2_l2_parallel(inputData, &parallel_outputData,
+                                              numThreads);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Thomas-Parallel in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &parallel_outputData)) {
+                    std::cout << "KKT-Thomas-Parallel solution is invalid!\n";
+                }
+
+                // Forward and backward sweeps meeting in the middle
+                OutputData bidi_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.solveBidirectional(inputData, &bidi_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[3][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Bidirectional in round " << iter
+                    << " in time " << runTimes[3][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &bidi_outputData)) {
+                    std::cout << "KKT-Bidirectional solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -139,4 +223,94 @@ void l2l2Profile(int rounds, const std::string& path) {
         std::cout << "Written in file " << filename << std::endl;
         std::cout << "////////////////////\n";
     }
+
+    // Case 3: Varying input sizes with missing observations (_cDev[i] = 0).
+    {
+        CSV sparseCsvData;
+        sparseCsvData._problemType = L2_L2;
+        sparseCsvData._p = 2;
+        sparseCsvData._q = 2;
+        sparseCsvData._genDataType = KKT_LP_LQ;
+        std::vector<std::string> sparseAlgsList = {"KKT", "KKT-Sparse"};
+        sparseCsvData.init(sparseAlgsList, numScales);
+        std::vector<std::vector<time_ms_type>> sparseRunTimes(
+            sparseAlgsList.size(), std::vector<time_ms_type>(rounds, 0));
+        data_type obsRatio = 0.1;
+        std::cout << "Run " << toString(sparseCsvData._problemType) << " with data "
+            << toString(sparseCsvData._genDataType)
+            << " for varying n and observation ratio " << obsRatio << std::endl;
+        n = 1;
+        for (int i = 0; i < numScales; ++i) {
+            n *= 10;
+            sparseCsvData._colTitles[i] = n;
+            sparseCsvData._n = n;
+            std::cout << "n = " << n << std::endl;
+            for (int iter = 0; iter < rounds; ++iter) {
+                InputData inputData(n, 2, 2);
+                genLpLqFuncs(n, &inputData);
+                genMissingObs(n, obsRatio, &inputData);
+                inputData._lb = -1;
+                inputData._ub = 1;
+
+                OutputData kkt_outputData(inputData);
+                auto start = std::chrono::steady_clock::now();
+                kktSolver.solve(inputData, &kkt_outputData);
+                auto end = std::chrono::steady_clock::now();
+                sparseRunTimes[0][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT in round " << iter
+                    << " in time " << sparseRunTimes[0][iter] << " ms\n";
+
+                OutputData sparse_outputData(inputData);
+                start = std::chrono::steady_clock::now();
+                kktSolver.solveSparse(inputData, &sparse_outputData);
+                end = std::chrono::steady_clock::now();
+                sparseRunTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Sparse in round " << iter
+                    << " in time " << sparseRunTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &sparse_outputData)) {
+                    std::cout << "KKT-Sparse solution is invalid!\n";
+                }
+
+                std::cout << "****\n";
+            }
+            for (int j = 0; j < sparseAlgsList.size(); ++j) {
+                double aveTime, stdTime;
+                stat(sparseRunTimes[j], &aveTime, &stdTime);
+                sparseCsvData._figures[j * 2][i] = aveTime;
+                sparseCsvData._figures[j * 2 + 1][i] = stdTime;
+            }
+            std::cout << "===========\n";
+        }
+        std::string filename = path + "/out_" + toString(sparseCsvData._problemType)
+            + "-sparse_" + toString(sparseCsvData._genDataType) + ".txt";
+        sparseCsvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
+
+    // Case 4: Strong scaling of the domain decomposition at fixed n.
+    {
+        CSV scalingCsvData;
+        scalingCsvData._problemType = L2_L2;
+        scalingCsvData._genDataType = KKT_LP_LQ;
+        scalingCsvData._p = 2;
+        scalingCsvData._q = 2;
+        n = SCALING_N;
+        scalingCsvData._n = n;
+        std::cout << "Run " << toString(scalingCsvData._problemType) << " with data "
+            << toString(scalingCsvData._genDataType) << " for n = " << n
+            << " and varying threads" << std::endl;
+        InputData inputData(n, 2, 2);
+        genLpLqFuncs(n, &inputData);
+        inputData._lb = -1;
+        inputData._ub = 1;
+        strongScalingProfile(inputData, rounds, &scalingCsvData);
+        std::string filename = path + "/out_" + toString(scalingCsvData._problemType)
+            + "_" + toString(scalingCsvData._genDataType) + "-SCALING.txt";
+        scalingCsvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
 }
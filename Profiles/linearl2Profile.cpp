@@ -7,7 +7,9 @@
 //
 
 #include "comparison_profiles.hpp"
+#include <algorithm>
 #include <iostream>
+#include <thread>
 
 void compLinearL2Obj(const InputData& inputData, OutputData* outputData) {
     assert(outputData != NULL);
@@ -16,7 +18,8 @@ void compLinearL2Obj(const InputData& inputData, OutputData* outputData) {
         outputData->_objVal += inputData._cDev[i] * outputData->_x[i];
     }
     for (int i = 0; i <inputData._n - 1; ++i) {
-        outputData->_objVal += 0.5 * (outputData->_x[i] - outputData->_x[i + 1]) *
+        outputData->_objVal += 0.5 * inputData._cSep[i] *
+                                (outputData->_x[i] - outputData->_x[i + 1]) *
                                 (outputData->_x[i] - outputData->_x[i + 1]);
     }
 }
@@ -38,6 +41,8 @@ void linearl2Profile(int rounds, const std::string& path) {
     csvData._genDataType = KKT_LINEAR_L2;
 
     int n = 1;
+    int numThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::cout << "Threads for KKT-Parallel: " << numThreads << std::endl;
 
     std::cout << "Run " << toString(csvData._problemType) << " with data "
         << toString(csvData._genDataType)
@@ -62,6 +67,21 @@ void linearl2Profile(int rounds, const std::string& path) {
             compLinearL2Obj(inputData, &kkt_outputData);
             std::cout << "Objective = " << kkt_outputData._objVal << std::endl;
 
+            // Blocked two-pass scan
+            OutputData par_outputData(inputData);
+            start = std::chrono::steady_clock::now();
+            kktSolver.fast_linear_l2(inputData, &par_outputData, 0, 0, numThreads);
+            end = std::chrono::steady_clock::now();
+            runTimes[1][iter] = std::chrono::duration_cast
+            <std::chrono::milliseconds>(end - start).count();
+            std::cout << "Complete KKT-Parallel in round " << iter
+            << " in time " << runTimes[1][iter] << " ms\n";
+            compLinearL2Obj(inputData, &par_outputData);
+            std::cout << "Objective = " << par_outputData._objVal << std::endl;
+            if (!solValid(inputData, &kkt_outputData, &par_outputData)) {
+                std::cout << "KKT-Parallel solution is invalid!\n";
+            }
+
             std::cout << "****\n";
         }
         for (int j = 0; j < algNum; ++j) {
@@ -103,4 +103,28 @@ void lplqProfile(int rounds, const std::string& path) {
         std::cout << "Written in file " << filename << std::endl;
         std::cout << "////////////////////\n";
     }
+
+    // Case 2: Strong scaling of the domain decomposition at fixed n.
+    {
+        CSV scalingCsvData;
+        scalingCsvData._problemType = LP_LQ;
+        scalingCsvData._genDataType = KKT_LP_LQ;
+        scalingCsvData._p = csvData._p;
+        scalingCsvData._q = csvData._q;
+        n = SCALING_N;
+        scalingCsvData._n = n;
+        std::cout << "Run " << toString(scalingCsvData._problemType) << " with data "
+            << toString(scalingCsvData._genDataType) << " for n = " << n
+            << " and varying threads" << std::endl;
+        InputData inputData(n, scalingCsvData._p, scalingCsvData._q);
+        genLpLqFuncs(n, &inputData);
+        inputData._lb = -1;
+        inputData._ub = 1;
+        strongScalingProfile(inputData, rounds, &scalingCsvData);
+        std::string filename = path + "/out_" + toString(scalingCsvData._problemType)
+            + "_" + toString(scalingCsvData._genDataType) + "-SCALING.txt";
+        scalingCsvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
 }
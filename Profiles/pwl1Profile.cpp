@@ -9,6 +9,14 @@
 #include "comparison_profiles.hpp"
 #include <iostream>
 
+// Tied inputs: TIE_CASES problems of TIE_N nodes, each with up to
+// TIE_MAX_BKPS integer breakpoints and integer separation weights around
+// TIE_LAMBDA.
+const int TIE_CASES = 10000;
+const int TIE_N = 10;
+const int TIE_MAX_BKPS = 4;
+const data_type TIE_LAMBDA = 2;
+
 void pwl1Profile(int rounds, const std::string& path) {
     assert(rounds > 0);
     std::vector<std::vector<time_ms_type>> runTimes;
@@ -56,6 +64,32 @@ void pwl1Profile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                OutputData fast_outputData(inputData);
+                // Function call to fast KKT
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_pwl1_l1(inputData, &fast_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Fast in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &fast_outputData)) {
+                    std::cout << "KKT-Fast solution is invalid!\n";
+                }
+
+                OutputData dp_outputData(inputData);
+                // Function call to the DP solver
+                start = std::chrono::steady_clock::now();
+                kktSolver.dp_solve(inputData, &dp_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete DP in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &dp_outputData)) {
+                    std::cout << "DP solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -103,6 +137,32 @@ void pwl1Profile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                OutputData fast_outputData(inputData);
+                // Function call to fast KKT
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_pwl1_l1(inputData, &fast_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Fast in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &fast_outputData)) {
+                    std::cout << "KKT-Fast solution is invalid!\n";
+                }
+
+                OutputData dp_outputData(inputData);
+                // Function call to the DP solver
+                start = std::chrono::steady_clock::now();
+                kktSolver.dp_solve(inputData, &dp_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete DP in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &dp_outputData)) {
+                    std::cout << "DP solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -150,6 +210,32 @@ void pwl1Profile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                OutputData fast_outputData(inputData);
+                // Function call to fast KKT
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_pwl1_l1(inputData, &fast_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Fast in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &fast_outputData)) {
+                    std::cout << "KKT-Fast solution is invalid!\n";
+                }
+
+                OutputData dp_outputData(inputData);
+                // Function call to the DP solver
+                start = std::chrono::steady_clock::now();
+                kktSolver.dp_solve(inputData, &dp_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete DP in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &dp_outputData)) {
+                    std::cout << "DP solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -166,4 +252,34 @@ void pwl1Profile(int rounds, const std::string& path) {
         std::cout << "Written in file " << filename << std::endl;
         std::cout << "////////////////////\n";
     }
+
+    // Case 3: Tied breakpoints, where the minimizer need not be unique;
+    // objectives are checked against DP.
+    std::cout << "Run " << toString(csvData._problemType) << " with data "
+        << toString(KKT_PWL1) << " on integer breakpoints for " << TIE_CASES
+        << " inputs of n = " << TIE_N << std::endl;
+    for (int iter = 0; iter < rounds; ++iter) {
+        int numInvalid = 0;
+        for (int k = 0; k < TIE_CASES; ++k) {
+            std::vector<int> bkpNums = genPWBkpNums(TIE_N, 1, TIE_MAX_BKPS);
+            std::vector<data_type> pw = genPWFuncs(TIE_N, 1, bkpNums);
+            quantizePWBkps(TIE_N, bkpNums, 1, &pw);
+            InputData inputData(TIE_N, 1, bkpNums, pw);
+            fillSep(TIE_N, &inputData, TIE_LAMBDA, true);
+            quantize(TIE_N - 1, 1, inputData._cSep);
+            OutputData fast_outputData(inputData);
+            kktSolver.fast_pwl1_l1(inputData, &fast_outputData);
+            OutputData dp_outputData(inputData);
+            kktSolver.dp_solve(inputData, &dp_outputData);
+            if (!objValid(inputData, &dp_outputData, &fast_outputData)) {
+                ++numInvalid;
+            }
+        }
+        std::cout << "Complete tied inputs in round " << iter << ": "
+            << numInvalid << " of " << TIE_CASES << " invalid\n";
+        if (numInvalid > 0) {
+            std::cout << "KKT-Fast solution is invalid!\n";
+        }
+    }
+    std::cout << "////////////////////\n";
 }
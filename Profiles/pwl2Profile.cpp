@@ -56,6 +56,32 @@ void pwl2Profile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                OutputData fast_outputData(inputData);
+                // Function call to fast KKT
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_pwl2_l1(inputData, &fast_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Fast in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &fast_outputData)) {
+                    std::cout << "KKT-Fast solution is invalid!\n";
+                }
+
+                OutputData dp_outputData(inputData);
+                // Function call to the DP solver
+                start = std::chrono::steady_clock::now();
+                kktSolver.dp_solve(inputData, &dp_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete DP in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &dp_outputData)) {
+                    std::cout << "DP solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -103,6 +129,32 @@ void pwl2Profile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                OutputData fast_outputData(inputData);
+                // Function call to fast KKT
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_pwl2_l1(inputData, &fast_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Fast in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &fast_outputData)) {
+                    std::cout << "KKT-Fast solution is invalid!\n";
+                }
+
+                OutputData dp_outputData(inputData);
+                // Function call to the DP solver
+                start = std::chrono::steady_clock::now();
+                kktSolver.dp_solve(inputData, &dp_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete DP in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &dp_outputData)) {
+                    std::cout << "DP solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
@@ -120,6 +172,29 @@ void pwl2Profile(int rounds, const std::string& path) {
         std::cout << "////////////////////\n";
     }
 
+    //   Case 1.3: Fix input size and weights, sweep lambda.
+    {
+        csvData._genDataType = KKT_PWL2;
+        std::cout << "Run " << toString(csvData._problemType) << " with data "
+            << toString(csvData._genDataType)
+            << " for fixed breakpoints and n, with a warm-started lambda sweep" << std::endl;
+        n = FIX_N;
+        csvData._n = n;
+        std::vector<int> bkpNums =
+            genPWBkpNums(n, PW_BKPNUM_UNIF_LEFT, PW_BKPNUM_UNIF_RIGHT);
+        std::vector<data_type> pw = genPWFuncs(n, 2, bkpNums);
+        InputData inputData(n, 2, bkpNums, pw);
+        // Unit-mean weights, scaled by each lambda.
+        fillSep(n, &inputData, 1, true);
+        lambdaSweepProfile(&inputData, rounds, &csvData);
+        std::string filename = path + "/out_" + toString(csvData._problemType)
+            + "_" + toString(csvData._genDataType) + "-SWEEP.txt";
+        csvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+        csvData.init(cpAlgsList, numScales);
+    }
+
     // Case 2: Fix input size, change the number of breakpoints.
     {
         csvData._genDataType = KKT_PWL2;
@@ -150,6 +225,32 @@ void pwl2Profile(int rounds, const std::string& path) {
                 std::cout << "Complete KKT in round " << iter
                     << " in time " << runTimes[0][iter] << " ms\n";
 
+                OutputData fast_outputData(inputData);
+                // Function call to fast KKT
+                start = std::chrono::steady_clock::now();
+                kktSolver.fast_pwl2_l1(inputData, &fast_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-Fast in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &fast_outputData)) {
+                    std::cout << "KKT-Fast solution is invalid!\n";
+                }
+
+                OutputData dp_outputData(inputData);
+                // Function call to the DP solver
+                start = std::chrono::steady_clock::now();
+                kktSolver.dp_solve(inputData, &dp_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete DP in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+                if (!solValid(inputData, &kkt_outputData, &dp_outputData)) {
+                    std::cout << "DP solution is invalid!\n";
+                }
+
                 std::cout << "****\n";
             }
             for (int j = 0; j < algNum; ++j) {
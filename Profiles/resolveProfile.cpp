@@ -0,0 +1,93 @@
+//
+//  resolveProfile.cpp
+//  KKT
+//
+
+#include "comparison_profiles.hpp"
+#include <iostream>
+
+// Number of nodes edited between the solve and the re-solve.
+const int RESOLVE_NUM_EDITS = 5;
+
+void resolveProfile(int rounds, const std::string& path) {
+    assert(rounds > 0);
+    // Update latencies are well below a millisecond, so keep fractions.
+    std::vector<std::vector<double>> runTimes;
+    CSV csvData;
+    csvData._problemType = RESOLVE;
+    csvData._genDataType = KKT_LP_LQ;
+    csvData._p = 2;
+    int numScales = NUM_SCALES;
+    size_t algNum = cpAlgs[csvData._problemType].size();
+    const std::vector<std::string>& cpAlgsList = cpAlgs[csvData._problemType];
+    csvData.init(cpAlgsList, numScales);
+    for (int i = 0; i < algNum; ++i) {
+        runTimes.push_back(std::vector<double>(rounds, 0));
+    }
+    std::vector<double> numResolved(rounds, 0);
+    int n;
+
+    // Case 1: l2-l1; Case 2: l2-l2.
+    for (int q = 1; q <= 2; ++q) {
+        csvData._q = q;
+        std::cout << "Run " << toString(csvData._problemType) << " with data "
+            << toString(csvData._genDataType) << " for l2-l" << q
+            << " and varying n, " << RESOLVE_NUM_EDITS << " edits" << std::endl;
+        n = 1;
+        for (int i = 0; i < numScales; ++i) {
+            n *= 10;
+            csvData._colTitles[i] = n;
+            csvData._n = n;
+            std::cout << "n = " << n << std::endl;
+            for (int iter = 0; iter < rounds; ++iter) {
+                InputData inputData(n, csvData._p, csvData._q);
+                genLpLqFuncs(n, &inputData, true);
+                inputData._lb = -1;
+                inputData._ub = 1;
+                OutputData resolve_outputData(inputData);
+                kktSolver.solve(inputData, &resolve_outputData);
+                std::vector<int> edited;
+                genLocalEdits(n, std::min(RESOLVE_NUM_EDITS, n), &inputData, &edited);
+
+                OutputData kkt_outputData(inputData);
+                // Function call to KKT: full re-solve.
+                auto start = std::chrono::steady_clock::now();
+                kktSolver.solve(inputData, &kkt_outputData);
+                auto end = std::chrono::steady_clock::now();
+                runTimes[0][iter] = std::chrono::duration<double, std::milli>(end - start).count();
+                std::cout << "Complete KKT in round " << iter
+                    << " in time " << runTimes[0][iter] << " ms\n";
+
+                // Function call to the incremental re-solve.
+                start = std::chrono::steady_clock::now();
+                numResolved[iter] = kktSolver.resolve(inputData, &resolve_outputData,
+                                                      edited, std::vector<int>());
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration<double, std::milli>(end - start).count();
+                std::cout << "Complete KKT-Resolve in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms, re-solving "
+                    << numResolved[iter] << " nodes\n";
+                if (!solValid(inputData, &kkt_outputData, &resolve_outputData)) {
+                    std::cout << "KKT-Resolve solution is invalid!\n";
+                }
+
+                std::cout << "****\n";
+            }
+            for (int j = 0; j < algNum; ++j) {
+                double aveTime, stdTime;
+                stat(runTimes[j], &aveTime, &stdTime);
+                csvData._figures[j * 2][i] = aveTime;
+                csvData._figures[j * 2 + 1][i] = stdTime;
+            }
+            double aveResolved;
+            stat(numResolved, &aveResolved);
+            std::cout << "Average nodes re-solved: " << aveResolved << std::endl;
+            std::cout << "===========\n";
+        }
+        std::string filename = path + "/out_" + toString(csvData._problemType)
+            + "-l2-l" + std::to_string(q) + "_" + toString(csvData._genDataType) + ".txt";
+        csvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
+}
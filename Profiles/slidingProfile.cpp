@@ -0,0 +1,126 @@
+//
+//  slidingProfile.cpp
+//  KKT
+//
+
+#include "comparison_profiles.hpp"
+#include <iostream>
+
+// Window sizes W = 10^SLIDING_MIN_SCALE, ..., 10^SLIDING_MAX_SCALE.
+const int SLIDING_MIN_SCALE = 4;
+const int SLIDING_MAX_SCALE = 6;
+// Timed pushes per round; the copy-and-solve baseline runs on the first few.
+const int SLIDING_UPDATES = 1000;
+const int SLIDING_BASELINE_UPDATES = 10;
+const data_type SLIDING_LAMBDA = 0.5;
+const data_type SLIDING_HUBER_DELTA = 0.3;
+
+void slidingProfile(int rounds, const std::string& path) {
+    assert(rounds > 0);
+    // Per-update latencies, averaged over the updates of a round, in ms.
+    std::vector<std::vector<double>> runTimes;
+    CSV csvData;
+    csvData._problemType = SLIDING;
+    csvData._genDataType = KKT_TV_ND;
+    csvData._p = 2;
+    csvData._q = 1;
+    int numScales = SLIDING_MAX_SCALE - SLIDING_MIN_SCALE + 1;
+    size_t algNum = cpAlgs[csvData._problemType].size();
+    const std::vector<std::string>& cpAlgsList = cpAlgs[csvData._problemType];
+    csvData.init(cpAlgsList, numScales);
+    for (int i = 0; i < algNum; ++i) {
+        runTimes.push_back(std::vector<double>(rounds, 0));
+    }
+
+    // Case 1: l2-TV; Case 2: Huber-TV.
+    std::vector<InputData::deviation_type> deviationTypes = {InputData::LP, InputData::HUBER_D};
+    for (int dvIndex = 0; dvIndex < deviationTypes.size(); ++dvIndex) {
+        InputData::deviation_type deviationType = deviationTypes[dvIndex];
+        std::string deviationName = deviationType == InputData::LP ? "l2" : "Huber";
+        std::cout << "Run " << toString(csvData._problemType) << " with data "
+            << toString(csvData._genDataType) << " for " << deviationName
+            << "-l1 and varying W, " << SLIDING_UPDATES << " updates" << std::endl;
+        int w = 1;
+        for (int i = 0; i < SLIDING_MIN_SCALE; ++i) {
+            w *= 10;
+        }
+        for (int i = 0; i < numScales; ++i, w *= 10) {
+            csvData._colTitles[i] = w;
+            csvData._n = w;
+            std::cout << "W = " << w << std::endl;
+            double maxLatency = 0, aveResolved = 0;
+            for (int iter = 0; iter < rounds; ++iter) {
+                std::vector<data_type> y;
+                genPiecewiseConstantArray({w + SLIDING_UPDATES}, &y);
+                InputData inputData(w, 2, 1, deviationType, InputData::LQ);
+                for (int k = 0; k < w; ++k) {
+                    inputData._aDev[k] = y[k];
+                    inputData._cDev[k] = 1;
+                    if (k < w - 1) {
+                        inputData._cSep[k] = SLIDING_LAMBDA;
+                    }
+                    if (inputData._huberD != NULL) {
+                        inputData._huberD[k] = SLIDING_HUBER_DELTA;
+                    }
+                }
+                KKTSlidingWindow slidingWindow(w, deviationType);
+                slidingWindow.assign(inputData);
+
+                bool isValid = true;
+                double baselineTime = 0, slidingTime = 0;
+                for (int k = 0; k < SLIDING_UPDATES; ++k) {
+                    // Function call to the sliding window.
+                    auto start = std::chrono::steady_clock::now();
+                    slidingWindow.push(y[w + k], 1, SLIDING_LAMBDA, SLIDING_HUBER_DELTA);
+                    auto end = std::chrono::steady_clock::now();
+                    double latency = std::chrono::duration<double, std::milli>(end - start).count();
+                    slidingTime += latency;
+                    maxLatency = std::max(maxLatency, latency);
+                    aveResolved += slidingWindow.lastResolved();
+                    if (k >= SLIDING_BASELINE_UPDATES) {
+                        continue;
+                    }
+
+                    // Function call to a fresh solve on a copied window.
+                    start = std::chrono::steady_clock::now();
+                    InputData window(w, 2, 1, deviationType, InputData::LQ);
+                    slidingWindow.copyWindow(&window);
+                    OutputData kkt_outputData(window);
+                    kktSolver.solveAuto(window, &kkt_outputData);
+                    end = std::chrono::steady_clock::now();
+                    baselineTime += std::chrono::duration<double, std::milli>(end - start).count();
+
+                    OutputData sliding_outputData(window);
+                    std::copy(slidingWindow.solution(), slidingWindow.solution() + w,
+                              sliding_outputData._x);
+                    isValid = isValid && solValid(window, &kkt_outputData, &sliding_outputData);
+                }
+                runTimes[0][iter] = baselineTime / SLIDING_BASELINE_UPDATES;
+                std::cout << "Complete Copy-Solve in round " << iter
+                    << " in time " << runTimes[0][iter] << " ms per update\n";
+                runTimes[1][iter] = slidingTime / SLIDING_UPDATES;
+                std::cout << "Complete Sliding in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms per update\n";
+                if (!isValid) {
+                    std::cout << "Sliding solution is invalid!\n";
+                }
+
+                std::cout << "****\n";
+            }
+            for (int j = 0; j < algNum; ++j) {
+                double aveTime, stdTime;
+                stat(runTimes[j], &aveTime, &stdTime);
+                csvData._figures[j * 2][i] = aveTime;
+                csvData._figures[j * 2 + 1][i] = stdTime;
+            }
+            std::cout << "Max Sliding latency: " << maxLatency << " ms, average nodes re-solved: "
+                << aveResolved / (rounds * SLIDING_UPDATES) << std::endl;
+            std::cout << "===========\n";
+        }
+        std::string filename = path + "/out_" + toString(csvData._problemType)
+            + "-" + deviationName + "_" + toString(csvData._genDataType) + ".txt";
+        csvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
+}
@@ -0,0 +1,163 @@
+//
+//  smallProfile.cpp
+//  KKT
+//
+
+#include "comparison_profiles.hpp"
+#include <iostream>
+#include <memory>
+
+// Solver calls per timing, cycling over SMALL_POOL_SIZE generated inputs.
+const int SMALL_CALLS = 100000;
+const int SMALL_POOL_SIZE = 64;
+// Capacity of the inline problem.
+const int SMALL_MAX_N = 512;
+
+// Compile-time n, as one of the fast_l2_l1_fixed instantiations.
+static void solveFixed(const InputData& inputData, data_type* x) {
+    switch (inputData._n) {
+        case 8:
+            kktSolver.fast_l2_l1_fixed<8>(inputData._cDev, inputData._aDev,
+                                          inputData._cSep, inputData._lb,
+                                          inputData._ub, inputData._solEsp, x);
+            break;
+        case 64:
+            kktSolver.fast_l2_l1_fixed<64>(inputData._cDev, inputData._aDev,
+                                           inputData._cSep, inputData._lb,
+                                           inputData._ub, inputData._solEsp, x);
+            break;
+        case 512:
+            kktSolver.fast_l2_l1_fixed<512>(inputData._cDev, inputData._aDev,
+                                            inputData._cSep, inputData._lb,
+                                            inputData._ub, inputData._solEsp, x);
+            break;
+        default:
+            assert(false);
+    }
+}
+
+void smallProfile(int rounds, const std::string& path) {
+    assert(rounds > 0);
+    std::vector<std::vector<time_ms_type>> runTimes;
+    CSV csvData;
+    csvData._problemType = SMALL;
+    csvData._genDataType = KKT_LP_LQ;
+    csvData._p = 2;
+    csvData._q = 1;
+    std::vector<int> sizes = {8, 64, 512};
+    int numScales = (int)sizes.size();
+    size_t algNum = cpAlgs[csvData._problemType].size();
+    const std::vector<std::string>& cpAlgsList = cpAlgs[csvData._problemType];
+    csvData.init(cpAlgsList, numScales);
+    for (int i = 0; i < algNum; ++i) {
+        runTimes.push_back(std::vector<time_ms_type>(rounds, 0));
+    }
+
+    std::cout << "Run " << toString(csvData._problemType) << " with data "
+        << toString(csvData._genDataType) << " for l2-l1, " << SMALL_CALLS
+        << " calls per n" << std::endl;
+    for (int i = 0; i < numScales; ++i) {
+        int n = sizes[i];
+        csvData._colTitles[i] = n;
+        csvData._n = n;
+        std::cout << "n = " << n << std::endl;
+        for (int iter = 0; iter < rounds; ++iter) {
+            std::vector<std::unique_ptr<InputData>> pool(SMALL_POOL_SIZE);
+            for (int k = 0; k < SMALL_POOL_SIZE; ++k) {
+                pool[k].reset(new InputData(n, csvData._p, csvData._q));
+                genLpLqFuncs(n, pool[k].get(), true);
+            }
+            // Each call copies a request into the solver's input, as a
+            // service does, and reads back x[0].
+            data_type checksum[3] = {0, 0, 0};
+
+            // Function call to fast_l2_l1 on a fresh InputData / OutputData.
+            auto start = std::chrono::steady_clock::now();
+            for (int k = 0; k < SMALL_CALLS; ++k) {
+                const InputData& request = *pool[k % SMALL_POOL_SIZE];
+                InputData inputData(n, csvData._p, csvData._q);
+                std::copy(request._cDev, request._cDev + n, inputData._cDev);
+                std::copy(request._aDev, request._aDev + n, inputData._aDev);
+                std::copy(request._cSep, request._cSep + n - 1, inputData._cSep);
+                OutputData outputData(inputData);
+                kktSolver.fast_l2_l1(inputData, &outputData);
+                checksum[0] += outputData._x[0];
+            }
+            auto end = std::chrono::steady_clock::now();
+            runTimes[0][iter] = std::chrono::duration_cast
+                <std::chrono::milliseconds>(end - start).count();
+            std::cout << "Complete KKT-Fast in round " << iter
+                << " in time " << runTimes[0][iter] << " ms\n";
+
+            // Inline buffers on the stack.
+            start = std::chrono::steady_clock::now();
+            for (int k = 0; k < SMALL_CALLS; ++k) {
+                const InputData& request = *pool[k % SMALL_POOL_SIZE];
+                SmallL2L1<SMALL_MAX_N> problem(n);
+                std::copy(request._cDev, request._cDev + n, problem._cDev);
+                std::copy(request._aDev, request._aDev + n, problem._aDev);
+                std::copy_n(request._cSep, n - 1, problem._cSep);
+                kktSolver.solveSmall(&problem);
+                checksum[1] += problem._x[0];
+            }
+            end = std::chrono::steady_clock::now();
+            runTimes[1][iter] = std::chrono::duration_cast
+                <std::chrono::milliseconds>(end - start).count();
+            std::cout << "Complete KKT-Small in round " << iter
+                << " in time " << runTimes[1][iter] << " ms\n";
+
+            // Compile-time n, reading the request in place.
+            data_type x[SMALL_MAX_N];
+            start = std::chrono::steady_clock::now();
+            for (int k = 0; k < SMALL_CALLS; ++k) {
+                solveFixed(*pool[k % SMALL_POOL_SIZE], x);
+                checksum[2] += x[0];
+            }
+            end = std::chrono::steady_clock::now();
+            runTimes[2][iter] = std::chrono::duration_cast
+                <std::chrono::milliseconds>(end - start).count();
+            std::cout << "Complete KKT-Small-Fixed in round " << iter
+                << " in time " << runTimes[2][iter] << " ms\n";
+
+            // All three run the same propagation.
+            for (int k = 0; k < SMALL_POOL_SIZE; ++k) {
+                OutputData kkt_outputData(*pool[k]);
+                kktSolver.fast_l2_l1(*pool[k], &kkt_outputData);
+                SmallL2L1<SMALL_MAX_N> problem(n);
+                std::copy(pool[k]->_cDev, pool[k]->_cDev + n, problem._cDev);
+                std::copy(pool[k]->_aDev, pool[k]->_aDev + n, problem._aDev);
+                std::copy(pool[k]->_cSep, pool[k]->_cSep + n - 1, problem._cSep);
+                kktSolver.solveSmall(&problem);
+                OutputData small_outputData(*pool[k]);
+                std::copy(problem._x, problem._x + n, small_outputData._x);
+                OutputData fixed_outputData(*pool[k]);
+                solveFixed(*pool[k], fixed_outputData._x);
+                if (!solValid(*pool[k], &kkt_outputData, &small_outputData)) {
+                    std::cout << "KKT-Small solution is invalid!\n";
+                }
+                if (!solValid(*pool[k], &kkt_outputData, &fixed_outputData)) {
+                    std::cout << "KKT-Small-Fixed solution is invalid!\n";
+                }
+            }
+            if (checksum[1] != checksum[0] || checksum[2] != checksum[0]) {
+                std::cout << "Checksums differ!\n";
+            }
+
+            std::cout << "****\n";
+        }
+        for (int j = 0; j < algNum; ++j) {
+            double aveTime, stdTime;
+            stat(runTimes[j], &aveTime, &stdTime);
+            csvData._figures[j * 2][i] = aveTime;
+            csvData._figures[j * 2 + 1][i] = stdTime;
+            std::cout << cpAlgsList[j] << ": "
+                << SMALL_CALLS * 1000.0 / std::max(aveTime, 1.0) << " calls/s\n";
+        }
+        std::cout << "===========\n";
+    }
+    std::string filename = path + "/out_" + toString(csvData._problemType)
+        + "-l2-l1_" + toString(csvData._genDataType) + ".txt";
+    csvData.write(filename);
+    std::cout << "Written in file " << filename << std::endl;
+    std::cout << "////////////////////\n";
+}
@@ -0,0 +1,104 @@
+//
+//  streamProfile.cpp
+//  KKT
+//
+
+#include "comparison_profiles.hpp"
+#include <iostream>
+
+// Nodes per pushed chunk.
+const int STREAM_CHUNK_SIZE = 4096;
+
+void streamProfile(int rounds, const std::string& path) {
+    assert(rounds > 0);
+    std::vector<std::vector<time_ms_type>> runTimes;
+    CSV csvData;
+    csvData._problemType = STREAM;
+    csvData._genDataType = KKT_LP_LQ;
+    csvData._q = 1;
+    int numScales = NUM_SCALES;
+    size_t algNum = cpAlgs[csvData._problemType].size();
+    const std::vector<std::string>& cpAlgsList = cpAlgs[csvData._problemType];
+    csvData.init(cpAlgsList, numScales);
+    for (int i = 0; i < algNum; ++i) {
+        runTimes.push_back(std::vector<time_ms_type>(rounds, 0));
+    }
+    int n;
+
+    // Case 1: l2-l1; Case 2: l1-l1.
+    for (int p = 2; p >= 1; --p) {
+        csvData._p = p;
+        std::cout << "Run " << toString(csvData._problemType) << " with data "
+            << toString(csvData._genDataType) << " for l" << p
+            << "-l1 and varying n, chunks of " << STREAM_CHUNK_SIZE << std::endl;
+        n = 1;
+        for (int i = 0; i < numScales; ++i) {
+            n *= 10;
+            csvData._colTitles[i] = n;
+            csvData._n = n;
+            std::cout << "n = " << n << std::endl;
+            int maxFrontier = 0, maxBkps = 0;
+            for (int iter = 0; iter < rounds; ++iter) {
+                InputData inputData(n, csvData._p, csvData._q);
+                genLpLqFuncs(n, &inputData, true);
+                inputData._lb = -1;
+                inputData._ub = 1;
+                // The stream reads one separation weight per node.
+                std::vector<data_type> cSep(inputData._cSep, inputData._cSep + n - 1);
+                cSep.push_back(0);
+
+                OutputData dp_outputData(inputData);
+                // Function call to DP on the whole input.
+                auto start = std::chrono::steady_clock::now();
+                kktSolver.dp_solve(inputData, &dp_outputData);
+                auto end = std::chrono::steady_clock::now();
+                runTimes[0][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete DP in round " << iter
+                    << " in time " << runTimes[0][iter] << " ms\n";
+
+                OutputData stream_outputData(inputData);
+                std::vector<data_type> x;
+                x.reserve(n);
+                // Function call to the stream, chunk by chunk.
+                start = std::chrono::steady_clock::now();
+                KKTStream stream(csvData._p, inputData._lb, inputData._ub);
+                for (int k = 0; k < n; k += STREAM_CHUNK_SIZE) {
+                    int m = std::min(STREAM_CHUNK_SIZE, n - k);
+                    stream.push(m, inputData._cDev + k, inputData._aDev + k,
+                                cSep.data() + k, &x);
+                    maxFrontier = std::max(maxFrontier, stream.frontierSize());
+                    maxBkps = std::max(maxBkps, stream.numBreakpoints());
+                }
+                stream.finish(&x);
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete Stream in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                std::copy(x.begin(), x.end(), stream_outputData._x);
+                if (x.size() != n ||
+                    !solValid(inputData, &dp_outputData, &stream_outputData)) {
+                    std::cout << "Stream solution is invalid!\n";
+                }
+
+                std::cout << "****\n";
+            }
+            for (int j = 0; j < algNum; ++j) {
+                double aveTime, stdTime;
+                stat(runTimes[j], &aveTime, &stdTime);
+                csvData._figures[j * 2][i] = aveTime;
+                csvData._figures[j * 2 + 1][i] = stdTime;
+            }
+            // After each chunk's emission.
+            std::cout << "Max frontier: " << maxFrontier << " nodes, "
+                << maxBkps << " breakpoints\n";
+            std::cout << "===========\n";
+        }
+        std::string filename = path + "/out_" + toString(csvData._problemType)
+            + "-l" + std::to_string(p) + "-l1_" + toString(csvData._genDataType) + ".txt";
+        csvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
+}
@@ -0,0 +1,92 @@
+//
+//  treeProfile.cpp
+//  KKT
+//
+
+#include "comparison_profiles.hpp"
+#include <iostream>
+
+void treeProfile(int rounds, const std::string& path) {
+    assert(rounds > 0);
+    std::vector<std::vector<time_ms_type>> runTimes;
+    CSV csvData;
+    csvData._problemType = TREE;
+    csvData._genDataType = KKT_LP_LQ;
+    csvData._p = 2;
+    csvData._q = 1;
+    int numScales = NUM_SCALES;
+    size_t algNum = cpAlgs[csvData._problemType].size();
+    const std::vector<std::string>& cpAlgsList = cpAlgs[csvData._problemType];
+    csvData.init(cpAlgsList, numScales);
+    for (int i = 0; i < algNum; ++i) {
+        runTimes.push_back(std::vector<time_ms_type>(rounds, 0));
+    }
+    int n;
+
+    std::cout << "Run " << toString(csvData._problemType) << " with data "
+        << toString(csvData._genDataType) << " and varying n" << std::endl;
+    n = 1;
+    for (int i = 0; i < numScales; ++i) {
+        n *= 10;
+        csvData._colTitles[i] = n;
+        csvData._n = n;
+        std::cout << "n = " << n << std::endl;
+        for (int iter = 0; iter < rounds; ++iter) {
+            // The same deviations and edge weights on every tree shape.
+            InputData inputData(n, csvData._p, csvData._q);
+            genLpLqFuncs(n, &inputData);
+
+            OutputData kkt_outputData(inputData);
+            // Function call to KKT
+            auto start = std::chrono::steady_clock::now();
+            kktSolver.solve(inputData, &kkt_outputData);
+            auto end = std::chrono::steady_clock::now();
+            runTimes[0][iter] = std::chrono::duration_cast
+                <std::chrono::milliseconds>(end - start).count();
+            std::cout << "Complete KKT in round " << iter
+                << " in time " << runTimes[0][iter] << " ms\n";
+
+            std::vector<int> parent(n);
+            for (int j = 1; j < algNum; ++j) {
+                if (j == 1) {
+                    parent[0] = -1;
+                    for (int k = 1; k < n; ++k) {
+                        parent[k] = k - 1;
+                    }
+                } else if (j == 2) {
+                    genRandomTree(n, &parent);
+                } else {
+                    genCaterpillarTree(n, &parent);
+                }
+                inputData.setTree(parent);
+                OutputData tree_outputData(inputData);
+                // Function call to the tree solver
+                start = std::chrono::steady_clock::now();
+                kktSolver.solveTree(inputData, &tree_outputData);
+                end = std::chrono::steady_clock::now();
+                runTimes[j][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete " << cpAlgsList[j] << " in round " << iter
+                    << " in time " << runTimes[j][iter] << " ms\n";
+                // Only the chain has a reference solution.
+                if (j == 1 && !solValid(inputData, &kkt_outputData, &tree_outputData)) {
+                    std::cout << cpAlgsList[j] << " solution is invalid!\n";
+                }
+            }
+
+            std::cout << "****\n";
+        }
+        for (int j = 0; j < algNum; ++j) {
+            double aveTime, stdTime;
+            stat(runTimes[j], &aveTime, &stdTime);
+            csvData._figures[j * 2][i] = aveTime;
+            csvData._figures[j * 2 + 1][i] = stdTime;
+        }
+        std::cout << "===========\n";
+    }
+    std::string filename = path + "/out_" + toString(csvData._problemType)
+        + "_" + toString(csvData._genDataType) + ".txt";
+    csvData.write(filename);
+    std::cout << "Written in file " << filename << std::endl;
+    std::cout << "////////////////////\n";
+}
@@ -0,0 +1,149 @@
+//
+//  tvndProfile.cpp
+//  KKT
+//
+
+#include "comparison_profiles.hpp"
+#include <iostream>
+#include <thread>
+
+// Images run on sides 64 * 2^i (4096 at the 7th scale), volumes on 8 * 2^i
+// (512^3 at the 7th scale, which needs about 6 GB for tv_prox).
+const int TV_ND_IMAGE_MIN_SIDE = 64;
+const int TV_ND_VOLUME_MIN_SIDE = 8;
+const data_type TV_ND_LAMBDA = 0.3;
+const int TV_ND_PROX_ITERS = 10;
+
+// The current practice: one InputData / OutputData per line, strided reads,
+// a single thread.
+static void solveLinesPerLine(const std::vector<int>& dims, int axis,
+                              const data_type* a, data_type* x) {
+    int len = dims[axis];
+    long long outer = 1, stride = 1;
+    for (int d = 0; d < axis; ++d) {
+        outer *= dims[d];
+    }
+    for (int d = axis + 1; d < dims.size(); ++d) {
+        stride *= dims[d];
+    }
+    for (long long o = 0; o < outer; ++o) {
+        for (long long i = 0; i < stride; ++i) {
+            const data_type* src = a + o * len * stride + i;
+            InputData inputData(len, 2, 1);
+            for (int j = 0; j < len; ++j) {
+                inputData._cDev[j] = 1;
+                inputData._aDev[j] = src[j * stride];
+            }
+            for (int j = 0; j < len - 1; ++j) {
+                inputData._cSep[j] = TV_ND_LAMBDA;
+            }
+            OutputData outputData(inputData);
+            kktSolver.fast_l2_l1(inputData, &outputData);
+            data_type* dst = x + o * len * stride + i;
+            for (int j = 0; j < len; ++j) {
+                dst[j * stride] = outputData._x[j];
+            }
+        }
+    }
+}
+
+void tvndProfile(int rounds, const std::string& path) {
+    assert(rounds > 0);
+    std::vector<std::vector<time_ms_type>> runTimes;
+    CSV csvData;
+    csvData._problemType = TV_ND;
+    csvData._genDataType = KKT_TV_ND;
+    csvData._p = 2;
+    csvData._q = 1;
+    int numScales = NUM_SCALES;
+    size_t algNum = cpAlgs[csvData._problemType].size();
+    const std::vector<std::string>& cpAlgsList = cpAlgs[csvData._problemType];
+    csvData.init(cpAlgsList, numScales);
+    for (int i = 0; i < algNum; ++i) {
+        runTimes.push_back(std::vector<time_ms_type>(rounds, 0));
+    }
+    int numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+
+    // Case 1: 2D images; Case 2: 3D volumes.
+    for (int numAxes = 2; numAxes <= 3; ++numAxes) {
+        std::string shapeName = numAxes == 2 ? "image" : "volume";
+        std::cout << "Run " << toString(csvData._problemType) << " with data "
+            << toString(csvData._genDataType) << " for " << shapeName
+            << "s and varying side length, " << numThreads << " threads" << std::endl;
+        int side = numAxes == 2 ? TV_ND_IMAGE_MIN_SIDE : TV_ND_VOLUME_MIN_SIDE;
+        for (int i = 0; i < numScales; ++i, side *= 2) {
+            std::vector<int> dims(numAxes, side);
+            long long size = 1;
+            for (int d = 0; d < numAxes; ++d) {
+                size *= side;
+            }
+            csvData._colTitles[i] = side;
+            csvData._n = (int)size;
+            std::cout << "side = " << side << std::endl;
+            for (int iter = 0; iter < rounds; ++iter) {
+                std::vector<data_type> y;
+                genPiecewiseConstantArray(dims, &y);
+                std::vector<data_type> kkt_x(size), x(size);
+
+                // Function call to per-line KKT: one sweep over every axis.
+                auto start = std::chrono::steady_clock::now();
+                for (int d = 0; d < numAxes; ++d) {
+                    solveLinesPerLine(dims, d, y.data(), kkt_x.data());
+                }
+                auto end = std::chrono::steady_clock::now();
+                runTimes[0][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete KKT-PerLine in round " << iter
+                    << " in time " << runTimes[0][iter] << " ms\n";
+
+                // Function call to solveLines: the same sweeps.
+                start = std::chrono::steady_clock::now();
+                for (int d = 0; d < numAxes; ++d) {
+                    kktSolver.solveLines(dims, d, y.data(), x.data(), 2, 1, 1,
+                                         TV_ND_LAMBDA, numThreads);
+                }
+                end = std::chrono::steady_clock::now();
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete Lines-Parallel in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                // Both hold the last axis sweep.
+                data_type maxDiff = 0;
+                for (long long k = 0; k < size; ++k) {
+                    maxDiff = std::max(maxDiff, (data_type)fabs(kkt_x[k] - x[k]));
+                }
+                if (maxDiff >= SOL_ESP) {
+                    std::cout << "MaxDiff = " << maxDiff << std::endl;
+                    std::cout << "Lines-Parallel solution is invalid!\n";
+                }
+                kkt_x.clear();
+                kkt_x.shrink_to_fit();
+
+                // Function call to tv_prox
+                std::vector<data_type> lambdas(numAxes, TV_ND_LAMBDA);
+                start = std::chrono::steady_clock::now();
+                kktSolver.tv_prox(dims, y.data(), 1, lambdas, x.data(),
+                                  TV_ND_PROX_ITERS, numThreads);
+                end = std::chrono::steady_clock::now();
+                runTimes[2][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete TV-Prox in round " << iter
+                    << " in time " << runTimes[2][iter] << " ms\n";
+
+                std::cout << "****\n";
+            }
+            for (int j = 0; j < algNum; ++j) {
+                double aveTime, stdTime;
+                stat(runTimes[j], &aveTime, &stdTime);
+                csvData._figures[j * 2][i] = aveTime;
+                csvData._figures[j * 2 + 1][i] = stdTime;
+            }
+            std::cout << "===========\n";
+        }
+        std::string filename = path + "/out_" + toString(csvData._problemType)
+            + "-" + shapeName + "_" + toString(csvData._genDataType) + ".txt";
+        csvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
+}
@@ -0,0 +1,140 @@
+//
+//  workspaceProfile.cpp
+//  KKT
+//
+
+#include "comparison_profiles.hpp"
+#include <iostream>
+#include <memory>
+
+// Nodes solved per timing: WORKSPACE_NODES / n calls, cycling over
+// WORKSPACE_POOL_SIZE generated requests.
+const int WORKSPACE_NODES = 1000000;
+const int WORKSPACE_POOL_SIZE = 16;
+const int WORKSPACE_MAX_SCALES = 5;
+
+// Case ${k} of the profile: 0: fast_l2_l1; 1: solve(); 2: fast_linear_l2.
+static void solveCase(int k, const InputData& inputData, OutputData* result) {
+    switch (k) {
+        case 0: kktSolver.fast_l2_l1(inputData, result); break;
+        case 1: kktSolver.solve(inputData, result); break;
+        default: kktSolver.fast_linear_l2(inputData, result);
+    }
+}
+
+static void solveCase(int k, KKTWorkspace* workspace) {
+    switch (k) {
+        case 0: kktSolver.fast_l2_l1(workspace); break;
+        case 1: kktSolver.solve(workspace); break;
+        default: kktSolver.fast_linear_l2(workspace);
+    }
+}
+
+void workspaceProfile(int rounds, const std::string& path) {
+    assert(rounds > 0);
+    std::vector<std::vector<time_ms_type>> runTimes;
+    CSV csvData;
+    csvData._problemType = WORKSPACE;
+    int numScales = std::min(NUM_SCALES, WORKSPACE_MAX_SCALES);
+    size_t algNum = cpAlgs[csvData._problemType].size();
+    const std::vector<std::string>& cpAlgsList = cpAlgs[csvData._problemType];
+    csvData.init(cpAlgsList, numScales);
+    for (int i = 0; i < algNum; ++i) {
+        runTimes.push_back(std::vector<time_ms_type>(rounds, 0));
+    }
+    const int ps[] = {2, 3, 1}, qs[] = {1, 2, 2};
+    const char* names[] = {"fast_l2_l1", "solve", "fast_linear_l2"};
+
+    for (int k = 0; k < 3; ++k) {
+        csvData._p = ps[k];
+        csvData._q = qs[k];
+        csvData._genDataType = k == 2 ? KKT_LINEAR_L2 : KKT_LP_LQ;
+        std::cout << "Run " << toString(csvData._problemType) << " with data "
+            << toString(csvData._genDataType) << " for " << names[k] << " (l"
+            << csvData._p << "-l" << csvData._q << ") and varying n, "
+            << WORKSPACE_NODES << " nodes per timing" << std::endl;
+        int n = 1;
+        for (int i = 0; i < numScales; ++i) {
+            n *= 10;
+            csvData._colTitles[i] = n;
+            csvData._n = n;
+            int calls = std::max(1, WORKSPACE_NODES / n);
+            std::cout << "n = " << n << ", " << calls << " calls" << std::endl;
+            // Heap allocations of the timed loops, solver included.
+            long long allocs[2] = {0, 0};
+            for (int iter = 0; iter < rounds; ++iter) {
+                std::vector<std::unique_ptr<InputData>> pool(WORKSPACE_POOL_SIZE);
+                for (int r = 0; r < WORKSPACE_POOL_SIZE; ++r) {
+                    pool[r].reset(new InputData(n, csvData._p, csvData._q));
+                    if (k == 2) {
+                        genLinearL2Funcs(n, pool[r].get());
+                    } else {
+                        genLpLqFuncs(n, pool[r].get(), true);
+                    }
+                }
+                // Each call copies a request into the solver's input, as a
+                // service does, and reads back x[0].
+                data_type checksum[2] = {0, 0};
+
+                // Function call on a fresh InputData / OutputData per request.
+                long long allocsBefore = numHeapAllocations();
+                auto start = std::chrono::steady_clock::now();
+                for (int c = 0; c < calls; ++c) {
+                    const InputData& request = *pool[c % WORKSPACE_POOL_SIZE];
+                    InputData inputData(n, csvData._p, csvData._q);
+                    std::copy(request._cDev, request._cDev + n, inputData._cDev);
+                    std::copy(request._aDev, request._aDev + n, inputData._aDev);
+                    std::copy(request._cSep, request._cSep + n - 1, inputData._cSep);
+                    OutputData outputData(inputData);
+                    solveCase(k, inputData, &outputData);
+                    checksum[0] += outputData._x[0];
+                }
+                auto end = std::chrono::steady_clock::now();
+                allocs[0] = numHeapAllocations() - allocsBefore;
+                runTimes[0][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete Fresh in round " << iter
+                    << " in time " << runTimes[0][iter] << " ms\n";
+
+                // One workspace for all requests.
+                KKTWorkspace workspace;
+                allocsBefore = numHeapAllocations();
+                start = std::chrono::steady_clock::now();
+                for (int c = 0; c < calls; ++c) {
+                    const InputData& request = *pool[c % WORKSPACE_POOL_SIZE];
+                    InputData& inputData = workspace.prepare(n, csvData._p, csvData._q);
+                    std::copy(request._cDev, request._cDev + n, inputData._cDev);
+                    std::copy(request._aDev, request._aDev + n, inputData._aDev);
+                    std::copy(request._cSep, request._cSep + n - 1, inputData._cSep);
+                    solveCase(k, &workspace);
+                    checksum[1] += workspace.output()._x[0];
+                }
+                end = std::chrono::steady_clock::now();
+                allocs[1] = numHeapAllocations() - allocsBefore;
+                runTimes[1][iter] = std::chrono::duration_cast
+                    <std::chrono::milliseconds>(end - start).count();
+                std::cout << "Complete Workspace in round " << iter
+                    << " in time " << runTimes[1][iter] << " ms\n";
+                if (checksum[1] != checksum[0]) {
+                    std::cout << "Workspace solution is invalid!\n";
+                }
+
+                std::cout << "****\n";
+            }
+            for (int j = 0; j < algNum; ++j) {
+                double aveTime, stdTime;
+                stat(runTimes[j], &aveTime, &stdTime);
+                csvData._figures[j * 2][i] = aveTime;
+                csvData._figures[j * 2 + 1][i] = stdTime;
+            }
+            std::cout << "Heap allocations per round: Fresh " << allocs[0]
+                << ", Workspace " << allocs[1] << " (" << calls << " calls)\n";
+            std::cout << "===========\n";
+        }
+        std::string filename = path + "/out_" + toString(csvData._problemType)
+            + "-" + names[k] + "_" + toString(csvData._genDataType) + ".txt";
+        csvData.write(filename);
+        std::cout << "Written in file " << filename << std::endl;
+        std::cout << "////////////////////\n";
+    }
+}
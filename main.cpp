@@ -36,8 +36,29 @@
 //  l2-Huber:
 //     - ceres
 //     - nlopt
+//  isotonic (LP / Huber deviations + l1 + x_i <= x_{i+1}):
+//     - Pool adjacent violators
+//  tree (l2-l1 on a rooted tree):
+//     - Tree solver on chain, random and caterpillar trees vs. the chain KKT
+//  tv-nd (l2-l1 on images and volumes):
+//     - Per-line InputData / fast_l2_l1 sweeps vs. solveLines, and tv_prox
+//  resolve (l2-l1 and l2-l2 after a few edits):
+//     - Incremental re-solve vs. a full re-solve
+//  stream (l2-l1 and l1-l1 pushed in chunks):
+//     - KKTStream vs. dp_solve on the whole input
+//  sliding (l2-TV and Huber-TV over the last W samples):
+//     - KKTSlidingWindow updates vs. solveAuto on a copied window
+//  batch (mixed-length l2-l1 and l3-l2 batches):
+//     - solveAuto per problem vs. solveBatch on one and on all cores
+//  channels (l2-l1 on 8 and 64 equal-length channels, per-channel throughput):
+//     - fast_l2_l1 per channel vs. solveBatch on one and on all cores
+//  small (l2-l1 at n = 8, 64 and 512, calls per second):
+//     - fast_l2_l1 on fresh InputData / OutputData vs. inline buffers
+//  workspace (fast_l2_l1, solve() and fast_linear_l2 in a request loop):
+//     - fresh InputData / OutputData per request vs. one KKTWorkspace
 
 #include "comparison_profiles.hpp"
+#include <cstring>
 #include <iostream>
 #include <string>
 
@@ -66,7 +87,17 @@ void help() {
         << "6. pwl2-l1\n"
         << "7. lp-lq\n"
         << "8. linear-l2\n"
-        << "9. Huber\n";
+        << "9. Huber\n"
+        << "10. isotonic\n"
+        << "11. tree\n"
+        << "12. tv-nd\n"
+        << "13. resolve\n"
+        << "14. stream\n"
+        << "15. sliding\n"
+        << "16. batch\n"
+        << "17. channels\n"
+        << "18. small\n"
+        << "19. workspace\n";
 }
 
 void printParams() {
@@ -109,6 +140,36 @@ problem_type setProblemType(std::string problemTypeStr) {
     if (problemTypeStr.compare("Huber") == 0) {
         return HUBER;
     }
+    if (problemTypeStr.compare("isotonic") == 0) {
+        return ISOTONIC;
+    }
+    if (problemTypeStr.compare("tree") == 0) {
+        return TREE;
+    }
+    if (problemTypeStr.compare("tv-nd") == 0) {
+        return TV_ND;
+    }
+    if (problemTypeStr.compare("resolve") == 0) {
+        return RESOLVE;
+    }
+    if (problemTypeStr.compare("stream") == 0) {
+        return STREAM;
+    }
+    if (problemTypeStr.compare("sliding") == 0) {
+        return SLIDING;
+    }
+    if (problemTypeStr.compare("batch") == 0) {
+        return BATCH;
+    }
+    if (problemTypeStr.compare("channels") == 0) {
+        return CHANNELS;
+    }
+    if (problemTypeStr.compare("small") == 0) {
+        return SMALL;
+    }
+    if (problemTypeStr.compare("workspace") == 0) {
+        return WORKSPACE;
+    }
     return LP_LQ;  // Default profile.
 }
 
@@ -213,6 +274,66 @@ int main(int argc, const char * argv[]) {
             std::cout << "Complete Huber profile.\n";
             break;
         }
+        case ISOTONIC: {
+            std::cout << "Start isotonic profile:\n";
+            isotonicProfile(ROUNDS, PATH);
+            std::cout << "Complete isotonic profile.\n";
+            break;
+        }
+        case TREE: {
+            std::cout << "Start tree profile:\n";
+            treeProfile(ROUNDS, PATH);
+            std::cout << "Complete tree profile.\n";
+            break;
+        }
+        case TV_ND: {
+            std::cout << "Start tv-nd profile:\n";
+            tvndProfile(ROUNDS, PATH);
+            std::cout << "Complete tv-nd profile.\n";
+            break;
+        }
+        case RESOLVE: {
+            std::cout << "Start resolve profile:\n";
+            resolveProfile(ROUNDS, PATH);
+            std::cout << "Complete resolve profile.\n";
+            break;
+        }
+        case STREAM: {
+            std::cout << "Start stream profile:\n";
+            streamProfile(ROUNDS, PATH);
+            std::cout << "Complete stream profile.\n";
+            break;
+        }
+        case SLIDING: {
+            std::cout << "Start sliding profile:\n";
+            slidingProfile(ROUNDS, PATH);
+            std::cout << "Complete sliding profile.\n";
+            break;
+        }
+        case BATCH: {
+            std::cout << "Start batch profile:\n";
+            batchProfile(ROUNDS, PATH);
+            std::cout << "Complete batch profile.\n";
+            break;
+        }
+        case CHANNELS: {
+            std::cout << "Start channels profile:\n";
+            channelsProfile(ROUNDS, PATH);
+            std::cout << "Complete channels profile.\n";
+            break;
+        }
+        case SMALL: {
+            std::cout << "Start small profile:\n";
+            smallProfile(ROUNDS, PATH);
+            std::cout << "Complete small profile.\n";
+            break;
+        }
+        case WORKSPACE: {
+            std::cout << "Start workspace profile:\n";
+            workspaceProfile(ROUNDS, PATH);
+            std::cout << "Complete workspace profile.\n";
+            break;
+        }
         case LP_LQ:
         default: {
             // Default to lp-lq.